@@ -0,0 +1,222 @@
+/*
+ * BatchedVariate.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "BatchedVariate.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <regex>
+#include <sstream>
+
+Register_PerRunConfigOption(CFGID_VARIATE_BLOCK_SIZE, "variate-block-size", CFG_INT, "0", "Variates of a parameter generated at a time by BatchedVariate; 0 evaluates the NED expression at every draw");
+
+namespace
+{
+    std::string trim(const std::string& text)
+    {
+        size_t start = text.find_first_not_of(" \t");
+        if (start == std::string::npos)
+            return "";
+        return text.substr(start, text.find_last_not_of(" \t") - start + 1);
+    }
+
+    // number literal with an optional unit, e.g. 40s or 0.5
+    bool parseQuantity(const std::string& text, double& value, std::string& unit)
+    {
+        static const std::regex quantity("[0-9.eE+-]+[a-zA-Z]*");
+        if (!std::regex_match(text, quantity))
+            return false;
+        try {
+            value = cNedValue::parseQuantity(text.c_str(), unit);
+        }
+        catch (std::exception& e) {
+            return false;
+        }
+        return true;
+    }
+}
+
+BatchedVariate::BatchedVariate()
+{
+    owner = nullptr;
+    parameter = nullptr;
+    kind = EVALUATE;
+    first = second = 0.0;
+    scale = 1.0;
+    tilt = 1.0;
+    rngIndex = 0;
+    rng = nullptr;
+    position = 0;
+    blockSize = 0;
+}
+
+void BatchedVariate::initialize(cComponent *owner, const char *parameterName)
+{
+    this->owner = owner;
+    parameter = &owner->par(parameterName);
+    buffer.clear();
+    position = 0;
+    tilt = 1.0;
+    blockSize = getEnvir()->getConfig()->getAsInt(CFGID_VARIATE_BLOCK_SIZE);
+
+    kind = EVALUATE;
+    if (!parameter->isExpression()) {
+        kind = CONSTANT;
+        first = parameter->doubleValue();
+    }
+    else if (blockSize > 0 && !compile(parameter->str(), parameter->getUnit()))
+        kind = EVALUATE;
+
+    if (kind == EXPONENTIAL || kind == UNIFORM) {
+        rng = owner->getRNG(rngIndex);
+        buffer.reserve(blockSize);
+    }
+}
+
+bool BatchedVariate::compile(const std::string& expression, const char *unit)
+{
+    static const std::regex call("\\s*(exponential|uniform)\\s*\\(([^()]*)\\)\\s*");
+    std::string targetUnit = unit ? unit : "";
+    std::smatch match;
+    std::string actualUnit;
+
+    if (!std::regex_match(expression, match, call)) {
+        // a plain quantity, e.g. a deadline of the iteration ${renegingTime}s
+        if (!parseQuantity(trim(expression), first, actualUnit))
+            return false;
+        kind = CONSTANT;
+        first = parameter->doubleValue();
+        return true;
+    }
+
+    std::vector<std::string> arguments;
+    std::stringstream list(match[2].str());
+    for (std::string argument; std::getline(list, argument, ',');)
+        arguments.push_back(trim(argument));
+
+    bool exponential = match[1] == "exponential";
+    size_t valueCount = exponential ? 1 : 2;
+    if (arguments.size() != valueCount && arguments.size() != valueCount + 1)
+        return false;
+
+    rngIndex = 0;
+    if (arguments.size() == valueCount + 1) {
+        char *end;
+        rngIndex = std::strtol(arguments.back().c_str(), &end, 10);
+        if (*end != '\0' || arguments.back().empty())
+            return false;
+    }
+
+    if (!parseQuantity(arguments[0], first, actualUnit))
+        return false;
+    if (!exponential) {
+        std::string secondUnit;
+        if (!parseQuantity(arguments[1], second, secondUnit) || secondUnit != actualUnit)
+            return false;
+    }
+
+    // the NED functions work in the unit of their argument, then the value is converted
+    if (actualUnit != targetUnit) {
+        if (actualUnit.empty() || targetUnit.empty())
+            return false;
+        try {
+            scale = cNedValue::convertUnit(1.0, actualUnit.c_str(), targetUnit.c_str());
+        }
+        catch (std::exception& e) {
+            return false;
+        }
+    }
+    else
+        scale = 1.0;
+
+    kind = exponential ? EXPONENTIAL : UNIFORM;
+    return true;
+}
+
+void BatchedVariate::refill()
+{
+    // uniforms first, in the order the expression would take them, then the
+    // transformation over the whole block
+    buffer.resize(blockSize);
+    for (size_t i = 0; i < blockSize; i++)
+        buffer[i] = rng->doubleRand();
+
+    double *values = buffer.data();
+    if (kind == EXPONENTIAL) {
+        for (size_t i = 0; i < blockSize; i++)
+            values[i] = -first * std::log(1.0 - values[i]);
+    }
+    else {
+        for (size_t i = 0; i < blockSize; i++)
+            values[i] = first + values[i] * (second - first);
+    }
+    if (scale != 1.0) {
+        for (size_t i = 0; i < blockSize; i++)
+            values[i] *= scale;
+    }
+    position = 0;
+}
+
+void BatchedVariate::setTilt(double factor)
+{
+    if (factor == tilt)
+        return;
+    if (kind != EXPONENTIAL || factor <= 0.0)
+        throw cRuntimeError("Cannot tilt %s = %s by %g: only exponential(mean) with variate-block-size > 0 and a positive factor", parameter->getFullPath().c_str(), parameter->str().c_str(), factor);
+
+    // the mean is kept tilted, so snapshots of variates with another tilt are not restored
+    first = first / tilt * factor;
+    tilt = factor;
+    buffer.clear();
+    position = 0;
+}
+
+std::string BatchedVariate::str() const
+{
+    std::ostringstream text;
+    switch (kind) {
+        case CONSTANT: text << "constant " << first; break;
+        case EXPONENTIAL: text << "exponential(" << first << ", rng " << rngIndex << ") x" << scale << ", blocks of " << blockSize; if (tilt != 1.0) text << ", tilted by " << tilt; break;
+        case UNIFORM: text << "uniform(" << first << ", " << second << ", rng " << rngIndex << ") x" << scale << ", blocks of " << blockSize; break;
+        default: text << "evaluated at every draw"; break;
+    }
+    return text.str();
+}
+
+void BatchedVariate::saveState(SnapshotWriter& out) const
+{
+    out.writeInt(kind);
+    out.writeDouble(first);
+    out.writeDouble(second);
+    out.writeDouble(scale);
+    size_t pending = buffer.size() - position;
+    out.writeInt(pending);
+    for (size_t i = position; i < buffer.size(); i++)
+        out.writeDouble(buffer[i]);
+}
+
+void BatchedVariate::restoreState(SnapshotReader& in)
+{
+    Kind savedKind = (Kind)in.readInt();
+    double savedFirst = in.readDouble();
+    double savedSecond = in.readDouble();
+    double savedScale = in.readDouble();
+    std::vector<double> pending(in.readInt());
+    for (double& value : pending)
+        value = in.readDouble();
+
+    // variates of another distribution (e.g. the deadline of the run that
+    // saved the snapshot) are dropped, the next draw starts a new block
+    buffer.clear();
+    position = 0;
+    if (savedKind != kind || savedFirst != first || savedSecond != second || savedScale != scale)
+        return;
+    if (kind == EXPONENTIAL || kind == UNIFORM) {
+        buffer = pending;
+        buffer.reserve(blockSize);
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ * BatchedVariate.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef BATCHEDVARIATE_H_
+#define BATCHEDVARIATE_H_
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "QueueingDefs.h"
+#include "Snapshot.h"
+
+/**
+ * Draws of a volatile double parameter, by default evaluating its NED
+ * expression every time. With variate-block-size > 0 (opt-in until the
+ * benchmarks show a gain) the expression is compiled at initialize() when it
+ * is a constant, exponential(mean[, rng]) or uniform(a, b[, rng]), with the
+ * arguments as number literals or quantities; the variates are then generated
+ * variate-block-size at a time into a buffer, with the same formulas as the
+ * OMNeT++ distributions, so every value is the one the expression would give
+ * for the same uniform number. Any other expression is evaluated at every
+ * draw, as before.
+ *
+ * A parameter with its own RNG (e.g. exponential(40s, 1)) gets exactly the
+ * sequence of the expression. When several parameters share an RNG, blocks
+ * change the order in which they take its numbers: runs stay reproducible
+ * for a given seed-set and block size, but differ from runs with
+ * variate-block-size = 0.
+ *
+ * For importance sampling an exponential variate can be tilted: its mean is
+ * multiplied by a factor and likelihoodRatio() gives the ratio between the
+ * original and the tilted density of a drawn value.
+ */
+class QUEUEING_API BatchedVariate
+{
+    public:
+        enum Kind { EVALUATE = 0, CONSTANT, EXPONENTIAL, UNIFORM };
+
+    private:
+        cComponent *owner;
+        cPar *parameter;
+        Kind kind;
+        double first;       // constant value, mean or lower bound, in the unit of the expression
+        double second;      // upper bound
+        double scale;       // from the unit of the expression to the unit of the parameter
+        double tilt;        // factor applied to the mean of an exponential, 1 if not tilted
+        int rngIndex;
+        cRNG *rng;
+
+        std::vector<double> buffer;
+        size_t position;
+        size_t blockSize;
+
+        bool compile(const std::string& expression, const char *unit);
+        void refill();
+
+    public:
+        BatchedVariate();
+
+        // compiles the expression of the parameter of owner
+        void initialize(cComponent *owner, const char *parameterName);
+
+        double draw() {
+            if (kind == CONSTANT)
+                return first;
+            if (kind == EVALUATE)
+                return parameter->doubleValue();
+            if (position == buffer.size())
+                refill();
+            return buffer[position++];
+        }
+
+        // draws from now on have their mean multiplied by factor (exponential only)
+        void setTilt(double factor);
+        double getTilt() const { return tilt; }
+
+        // draw of the original distribution, from the tilted variates
+        double drawUntilted() { return draw() / tilt; }
+
+        // original over tilted density of value, 1 if not tilted
+        double likelihoodRatio(double value) const {
+            if (tilt == 1.0)
+                return 1.0;
+            double tiltedMean = first * scale;
+            return tilt * std::exp(value / tiltedMean * (1.0 - tilt));
+        }
+
+        Kind getKind() const { return kind; }
+        std::string str() const;
+
+        // the variates drawn from the RNG but not used yet; they are only
+        // restored into a parameter with the same distribution
+        void saveState(SnapshotWriter& out) const;
+        void restoreState(SnapshotReader& in);
+};
+
+#endif /* BATCHEDVARIATE_H_ */
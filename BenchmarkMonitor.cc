@@ -0,0 +1,130 @@
+/*
+ * BenchmarkMonitor.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "BenchmarkMonitor.h"
+
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+Define_Module(BenchmarkMonitor);
+
+BenchmarkMonitor::BenchmarkMonitor()
+{
+    sampleMsg = nullptr;
+}
+
+BenchmarkMonitor::~BenchmarkMonitor()
+{
+    cancelAndDelete(sampleMsg);
+}
+
+void BenchmarkMonitor::initialize()
+{
+    peakFesLength = 0;
+    sampleEvents = 0;
+    WATCH(peakFesLength);
+
+    sampleMsg = new cMessage("sample_fes");
+    if (par("sampleInterval").doubleValue() > 0)
+        scheduleAt(simTime() + par("sampleInterval"), sampleMsg);
+
+    startEvent = getSimulation()->getEventNumber();
+    startTime = std::chrono::steady_clock::now();
+}
+
+void BenchmarkMonitor::handleMessage(cMessage *msg)
+{
+    ASSERT(msg == sampleMsg);
+    sampleEvents++;
+    sampleFes();
+    scheduleAt(simTime() + par("sampleInterval"), sampleMsg);
+}
+
+void BenchmarkMonitor::sampleFes()
+{
+    // our own sample message is in the FES only between samples
+    int length = getSimulation()->getFES()->getLength();
+    if (length > peakFesLength)
+        peakFesLength = length;
+}
+
+void BenchmarkMonitor::finish()
+{
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    sampleFes();
+
+    // the sample messages are not part of the measured model
+    eventnumber_t events = getSimulation()->getEventNumber() - startEvent - sampleEvents;
+    long peakRss = getPeakResidentSetKiB();
+
+    recordScalar("benchmark:events", events);
+    recordScalar("benchmark:elapsed", elapsed, "s");
+    recordScalar("benchmark:eventsPerSecond", elapsed > 0 ? events / elapsed : 0.0);
+    recordScalar("benchmark:nsPerEvent", events > 0 ? elapsed * 1e9 / events : 0.0, "ns");
+    recordScalar("benchmark:peakFesLength", peakFesLength);
+    recordScalar("benchmark:peakRss", peakRss, "KiB");
+
+    EV_INFO << "Benchmark: " << events << " events in " << elapsed << "s, peak FES " << peakFesLength << ", peak RSS " << peakRss << " KiB" << endl;
+
+    if (!par("resultFile").stdstringValue().empty())
+        appendResult(elapsed, events, peakRss);
+}
+
+void BenchmarkMonitor::appendResult(double elapsed, eventnumber_t events, long peakRss)
+{
+    cConfigurationEx *config = getEnvir()->getConfigEx();
+
+    // one JSON object per line, so runs executed in parallel can append to the same file
+    std::ostringstream line;
+    line << "{\"config\": " << jsonString(config->getVariable(CFGVAR_CONFIGNAME))
+         << ", \"run\": " << config->getVariable(CFGVAR_RUNNUMBER)
+         << ", \"iterationvars\": " << jsonString(config->getVariable(CFGVAR_ITERATIONVARS))
+         << ", \"simTime\": " << simTime().dbl()
+         << ", \"events\": " << events
+         << ", \"elapsed\": " << elapsed
+         << ", \"eventsPerSecond\": " << (elapsed > 0 ? events / elapsed : 0.0)
+         << ", \"nsPerEvent\": " << (events > 0 ? elapsed * 1e9 / events : 0.0)
+         << ", \"peakFesLength\": " << peakFesLength
+         << ", \"peakRssKiB\": " << peakRss
+         << "}\n";
+
+    std::ofstream output(par("resultFile").stdstringValue(), std::ios::app);
+    if (!output)
+        throw cRuntimeError("cannot write benchmark results to %s", par("resultFile").stringValue());
+    output << line.str();
+}
+
+long BenchmarkMonitor::getPeakResidentSetKiB()
+{
+#ifdef _WIN32
+    return -1;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;  // bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+std::string BenchmarkMonitor::jsonString(const std::string& text)
+{
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\')
+            quoted += '\\';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
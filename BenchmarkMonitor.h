@@ -0,0 +1,46 @@
+/*
+ * BenchmarkMonitor.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef BENCHMARKMONITOR_H_
+#define BENCHMARKMONITOR_H_
+
+#include <chrono>
+#include <string>
+
+#include "QueueingDefs.h"
+
+/**
+ * Measures the speed of the simulation it is part of: events per second,
+ * wall-clock nanoseconds per event (i.e. per handleMessage), peak length of
+ * the future event set and peak resident memory. See NED file for more info.
+ */
+class QUEUEING_API BenchmarkMonitor : public cSimpleModule
+{
+    private:
+        cMessage *sampleMsg;
+        std::chrono::steady_clock::time_point startTime;
+        eventnumber_t startEvent;
+        eventnumber_t sampleEvents;
+        int peakFesLength;
+
+        void sampleFes();
+        void appendResult(double elapsed, eventnumber_t events, long peakRss);
+
+        static long getPeakResidentSetKiB();
+        static std::string jsonString(const std::string& text);
+
+    public:
+        BenchmarkMonitor();
+        virtual ~BenchmarkMonitor();
+
+    protected:
+        virtual void initialize() override;
+        virtual void handleMessage(cMessage *msg) override;
+        virtual void finish() override;
+};
+
+#endif /* BENCHMARKMONITOR_H_ */
@@ -0,0 +1,129 @@
+/*
+ * ColumnarOutputVectorManager.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "ColumnarOutputVectorManager.h"
+
+#include <stdexcept>
+
+Register_Class(ColumnarOutputVectorManager);
+
+Register_PerRunConfigOption(CFGID_COLUMNAR_FLOAT32, "columnar-vector-float32", CFG_BOOL, "false", "Store the values of the columnar output vectors as float32 instead of float64");
+Register_PerRunConfigOption(CFGID_COLUMNAR_DEFLATE, "columnar-vector-compression", CFG_BOOL, "true", "Compress every block of the columnar output vectors with zlib");
+Register_PerRunConfigOption(CFGID_COLUMNAR_BLOCK_SIZE, "columnar-vector-block-size", CFG_INT, "65536", "Samples per block of the columnar output vectors");
+
+ColumnarOutputVectorManager::ColumnarOutputVectorManager()
+{
+    writer = nullptr;
+}
+
+ColumnarOutputVectorManager::~ColumnarOutputVectorManager()
+{
+    delete writer;
+    for (VectorHandle *handle : handles)
+        delete handle;
+}
+
+void ColumnarOutputVectorManager::startRun()
+{
+    delete writer;
+    for (VectorHandle *handle : handles)
+        delete handle;
+    handles.clear();
+
+    cConfiguration *config = getEnvir()->getConfig();
+    writer = new ColumnarVectorFormat::Writer(config->getAsInt(CFGID_COLUMNAR_BLOCK_SIZE), config->getAsBool(CFGID_COLUMNAR_FLOAT32), config->getAsBool(CFGID_COLUMNAR_DEFLATE));
+
+    // same name as the .vec file would have
+    fileName = config->getAsFilename(cConfigOption::find("output-vector-file"));
+    if (fileName.size() > 4 && fileName.compare(fileName.size() - 4, 4, ".vec") == 0)
+        fileName.resize(fileName.size() - 4);
+    fileName += ".cvec";
+}
+
+void ColumnarOutputVectorManager::openFile()
+{
+    cConfigurationEx *config = getEnvir()->getConfigEx();
+    std::map<std::string, std::string> runAttributes;
+    runAttributes["configname"] = config->getVariable(CFGVAR_CONFIGNAME);
+    runAttributes["runnumber"] = config->getVariable(CFGVAR_RUNNUMBER);
+    runAttributes["iterationvars"] = config->getVariable(CFGVAR_ITERATIONVARS);
+    runAttributes["seedset"] = config->getVariable(CFGVAR_SEEDSET);
+    runAttributes["network"] = config->getVariable(CFGVAR_NETWORK);
+
+    try {
+        writer->open(fileName, SimTime::getScaleExp(), runAttributes);
+    }
+    catch (const std::exception& e) {
+        throw cRuntimeError("%s", e.what());
+    }
+}
+
+void ColumnarOutputVectorManager::endRun()
+{
+    if (!writer)
+        return;
+    try {
+        writer->close();
+    }
+    catch (const std::exception& e) {
+        throw cRuntimeError("%s", e.what());
+    }
+}
+
+void *ColumnarOutputVectorManager::registerVector(const char *modulename, const char *vectorname)
+{
+    VectorHandle *handle = new VectorHandle();
+    handle->module = modulename;
+    handle->name = vectorname;
+    std::string path = handle->module + "." + handle->name;
+    handle->enabled = getEnvir()->getConfig()->getAsBool(path.c_str(), cConfigOption::find("vector-recording"), true);
+    handle->registered = false;
+    handle->id = 0;
+    handles.push_back(handle);
+    return handle;
+}
+
+void ColumnarOutputVectorManager::deregisterVector(void *vechandle)
+{
+    // the vector stays in the index; its handle is freed with the others
+    static_cast<VectorHandle *>(vechandle)->enabled = false;
+}
+
+void ColumnarOutputVectorManager::setVectorAttribute(void *vechandle, const char *name, const char *value)
+{
+    // attributes come before the first sample, the vector is added to the
+    // file only when something is recorded
+    VectorHandle *handle = static_cast<VectorHandle *>(vechandle);
+    if (handle->registered)
+        writer->setAttribute(handle->id, name, value);
+    else
+        handle->attributes[name] = value;
+}
+
+bool ColumnarOutputVectorManager::record(void *vechandle, simtime_t t, double value)
+{
+    VectorHandle *handle = static_cast<VectorHandle *>(vechandle);
+    if (!handle->enabled)
+        return false;
+
+    if (!writer->isOpen())
+        openFile();
+    if (!handle->registered) {
+        handle->id = writer->addVector(handle->module, handle->name);
+        for (const auto& attribute : handle->attributes)
+            writer->setAttribute(handle->id, attribute.first, attribute.second);
+        handle->registered = true;
+    }
+    writer->record(handle->id, t.raw(), value);
+    return true;
+}
+
+void ColumnarOutputVectorManager::flush()
+{
+    if (writer)
+        writer->flush();
+}
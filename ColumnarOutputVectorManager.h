@@ -0,0 +1,60 @@
+/*
+ * ColumnarOutputVectorManager.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef COLUMNAROUTPUTVECTORMANAGER_H_
+#define COLUMNAROUTPUTVECTORMANAGER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "QueueingDefs.h"
+#include "ColumnarVectorFormat.h"
+
+/**
+ * Output vector manager writing the compact columnar format described in
+ * ColumnarVectorFormat.h instead of .vec files. Select it with
+ *
+ *   outputvectormanager-class = "ColumnarOutputVectorManager"
+ *
+ * The file is named after output-vector-file with a .cvec extension and is
+ * only created when something is recorded. vector-recording is honored;
+ * vector-recording-intervals and event numbers are not supported.
+ */
+class QUEUEING_API ColumnarOutputVectorManager : public cIOutputVectorManager
+{
+    private:
+        struct VectorHandle {
+            std::string module;
+            std::string name;
+            std::map<std::string, std::string> attributes;
+            bool enabled;
+            bool registered;
+            uint32_t id;
+        };
+
+        ColumnarVectorFormat::Writer *writer;
+        std::string fileName;
+        std::vector<VectorHandle *> handles;
+
+        void openFile();
+
+    public:
+        ColumnarOutputVectorManager();
+        virtual ~ColumnarOutputVectorManager();
+
+        virtual void startRun() override;
+        virtual void endRun() override;
+        virtual void *registerVector(const char *modulename, const char *vectorname) override;
+        virtual void deregisterVector(void *vechandle) override;
+        virtual void setVectorAttribute(void *vechandle, const char *name, const char *value) override;
+        virtual bool record(void *vechandle, simtime_t t, double value) override;
+        virtual const char *getFileName() const override { return fileName.c_str(); }
+        virtual void flush() override;
+};
+
+#endif /* COLUMNAROUTPUTVECTORMANAGER_H_ */
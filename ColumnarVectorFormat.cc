@@ -0,0 +1,402 @@
+/*
+ * ColumnarVectorFormat.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "ColumnarVectorFormat.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <zlib.h>
+
+namespace ColumnarVectorFormat
+{
+    void putVarint(std::string& out, uint64_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back((char)(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back((char)value);
+    }
+
+    void putSignedVarint(std::string& out, int64_t value)
+    {
+        putVarint(out, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+    }
+
+    void putFixed(std::string& out, uint64_t value, int bytes)
+    {
+        for (int i = 0; i < bytes; i++)
+            out.push_back((char)(value >> (8 * i)));
+    }
+
+    void putDouble(std::string& out, double value)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        putFixed(out, bits, 8);
+    }
+
+    void putString(std::string& out, const std::string& value)
+    {
+        putVarint(out, value.size());
+        out.append(value);
+    }
+
+    uint64_t Cursor::getVarint()
+    {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = *take(1);
+            value |= (uint64_t)(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return value;
+        }
+        throw std::runtime_error("malformed varint");
+    }
+
+    int64_t Cursor::getSignedVarint()
+    {
+        uint64_t value = getVarint();
+        return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    }
+
+    uint64_t Cursor::getFixed(int bytes)
+    {
+        const unsigned char *data = take(bytes);
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; i++)
+            value |= (uint64_t)data[i] << (8 * i);
+        return value;
+    }
+
+    double Cursor::getDouble()
+    {
+        uint64_t bits = getFixed(8);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    float Cursor::getFloat()
+    {
+        uint32_t bits = getFixed(4);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string Cursor::getString()
+    {
+        uint64_t size = getVarint();
+        const unsigned char *data = take(size);
+        return std::string((const char *)data, size);
+    }
+
+    const unsigned char *Cursor::take(size_t bytes)
+    {
+        if (bytes > remaining())
+            throw std::runtime_error("truncated columnar vector data");
+        const unsigned char *data = position;
+        position += bytes;
+        return data;
+    }
+
+    namespace
+    {
+        std::string deflateColumn(const std::string& raw)
+        {
+            uLongf size = compressBound(raw.size());
+            std::string compressed(size, '\0');
+            if (compress2((Bytef *)&compressed[0], &size, (const Bytef *)raw.data(), raw.size(), Z_DEFAULT_COMPRESSION) != Z_OK)
+                throw std::runtime_error("cannot compress a vector block");
+            compressed.resize(size);
+            return compressed;
+        }
+
+        std::string inflateColumn(const unsigned char *data, size_t size, size_t rawSize)
+        {
+            std::string raw(rawSize, '\0');
+            uLongf length = rawSize;
+            if (uncompress((Bytef *)&raw[0], &length, data, size) != Z_OK || length != rawSize)
+                throw std::runtime_error("corrupted compressed vector block");
+            return raw;
+        }
+    }
+
+    std::string encodeBlock(uint32_t vectorId, const std::vector<int64_t>& times, const std::vector<double>& values, uint8_t flags)
+    {
+        // times of a vector never decrease, so the deltas are small
+        std::string timeColumn;
+        int64_t previous = 0;
+        for (int64_t time : times) {
+            putSignedVarint(timeColumn, time - previous);
+            previous = time;
+        }
+
+        std::string valueColumn;
+        valueColumn.reserve(values.size() * ((flags & FLOAT32) ? 4 : 8));
+        for (double value : values) {
+            if (flags & FLOAT32) {
+                float single = (float)value;
+                uint32_t bits;
+                std::memcpy(&bits, &single, sizeof(bits));
+                putFixed(valueColumn, bits, 4);
+            }
+            else
+                putDouble(valueColumn, value);
+        }
+
+        std::string block;
+        putFixed(block, vectorId, 4);
+        putFixed(block, times.size(), 4);
+        block.push_back((char)flags);
+        if (flags & DEFLATE) {
+            std::string timeCompressed = deflateColumn(timeColumn);
+            std::string valueCompressed = deflateColumn(valueColumn);
+            putFixed(block, timeCompressed.size(), 4);
+            putFixed(block, valueCompressed.size(), 4);
+            putFixed(block, timeColumn.size(), 4);
+            putFixed(block, valueColumn.size(), 4);
+            block.append(timeCompressed);
+            block.append(valueCompressed);
+        }
+        else {
+            putFixed(block, timeColumn.size(), 4);
+            putFixed(block, valueColumn.size(), 4);
+            block.append(timeColumn);
+            block.append(valueColumn);
+        }
+        return block;
+    }
+
+    void decodeBlock(const void *data, size_t size, std::vector<int64_t>& times, std::vector<double>& values)
+    {
+        Cursor block(data, size);
+        block.getFixed(4);
+        uint64_t samples = block.getFixed(4);
+        uint8_t flags = block.getFixed(1);
+        uint64_t timeBytes = block.getFixed(4);
+        uint64_t valueBytes = block.getFixed(4);
+
+        std::string timeColumn, valueColumn;
+        if (flags & DEFLATE) {
+            uint64_t timeRawBytes = block.getFixed(4);
+            uint64_t valueRawBytes = block.getFixed(4);
+            timeColumn = inflateColumn(block.take(timeBytes), timeBytes, timeRawBytes);
+            valueColumn = inflateColumn(block.take(valueBytes), valueBytes, valueRawBytes);
+        }
+        else {
+            timeColumn.assign((const char *)block.take(timeBytes), timeBytes);
+            valueColumn.assign((const char *)block.take(valueBytes), valueBytes);
+        }
+
+        Cursor timeCursor(timeColumn.data(), timeColumn.size());
+        Cursor valueCursor(valueColumn.data(), valueColumn.size());
+        int64_t time = 0;
+        times.reserve(times.size() + samples);
+        values.reserve(values.size() + samples);
+        for (uint64_t i = 0; i < samples; i++) {
+            time += timeCursor.getSignedVarint();
+            times.push_back(time);
+            values.push_back((flags & FLOAT32) ? valueCursor.getFloat() : valueCursor.getDouble());
+        }
+    }
+
+    std::string encodeIndex(const Index& index)
+    {
+        std::string out;
+        putSignedVarint(out, index.scaleExp);
+        putVarint(out, index.runAttributes.size());
+        for (const auto& attribute : index.runAttributes) {
+            putString(out, attribute.first);
+            putString(out, attribute.second);
+        }
+
+        putVarint(out, index.vectors.size());
+        for (const VectorInfo& vector : index.vectors) {
+            putVarint(out, vector.id);
+            putString(out, vector.module);
+            putString(out, vector.name);
+            putVarint(out, vector.attributes.size());
+            for (const auto& attribute : vector.attributes) {
+                putString(out, attribute.first);
+                putString(out, attribute.second);
+            }
+            out.push_back((char)vector.flags);
+            putVarint(out, vector.samples);
+            putDouble(out, vector.min);
+            putDouble(out, vector.max);
+            putDouble(out, vector.sum);
+            putVarint(out, vector.blocks.size());
+            for (const BlockInfo& block : vector.blocks) {
+                putVarint(out, block.offset);
+                putVarint(out, block.samples);
+                putSignedVarint(out, block.firstTime);
+                putSignedVarint(out, block.lastTime);
+            }
+        }
+        return out;
+    }
+
+    Index decodeIndex(const void *data, size_t size)
+    {
+        Cursor in(data, size);
+        Index index;
+        index.scaleExp = in.getSignedVarint();
+        uint64_t runAttributes = in.getVarint();
+        for (uint64_t i = 0; i < runAttributes; i++) {
+            std::string key = in.getString();
+            index.runAttributes[key] = in.getString();
+        }
+
+        uint64_t vectors = in.getVarint();
+        for (uint64_t i = 0; i < vectors; i++) {
+            VectorInfo vector;
+            vector.id = in.getVarint();
+            vector.module = in.getString();
+            vector.name = in.getString();
+            uint64_t attributes = in.getVarint();
+            for (uint64_t j = 0; j < attributes; j++) {
+                std::string key = in.getString();
+                vector.attributes[key] = in.getString();
+            }
+            vector.flags = in.getFixed(1);
+            vector.samples = in.getVarint();
+            vector.min = in.getDouble();
+            vector.max = in.getDouble();
+            vector.sum = in.getDouble();
+            uint64_t blocks = in.getVarint();
+            for (uint64_t j = 0; j < blocks; j++) {
+                BlockInfo block;
+                block.offset = in.getVarint();
+                block.samples = in.getVarint();
+                block.firstTime = in.getSignedVarint();
+                block.lastTime = in.getSignedVarint();
+                vector.blocks.push_back(block);
+            }
+            index.vectors.push_back(vector);
+        }
+        return index;
+    }
+
+    Writer::Writer(size_t blockSize, bool float32, bool deflate)
+    {
+        file = nullptr;
+        offset = 0;
+        this->blockSize = std::max<size_t>(blockSize, 1);
+        flags = (float32 ? FLOAT32 : 0) | (deflate ? DEFLATE : 0);
+        index.scaleExp = 0;
+    }
+
+    Writer::~Writer()
+    {
+        if (file)
+            fclose(file);
+    }
+
+    void Writer::open(const std::string& fileName, int scaleExp, const std::map<std::string, std::string>& runAttributes)
+    {
+        file = fopen(fileName.c_str(), "wb");
+        if (!file)
+            throw std::runtime_error("cannot open " + fileName + " for writing");
+        this->fileName = fileName;
+        offset = 0;
+        index.scaleExp = scaleExp;
+        index.runAttributes = runAttributes;
+
+        std::string header(FILE_MAGIC, sizeof(FILE_MAGIC));
+        putFixed(header, VERSION, 4);
+        write(header);
+    }
+
+    uint32_t Writer::addVector(const std::string& module, const std::string& name)
+    {
+        VectorInfo vector;
+        vector.id = index.vectors.size();
+        vector.module = module;
+        vector.name = name;
+        vector.flags = flags;
+        vector.samples = 0;
+        vector.min = vector.max = vector.sum = 0.0;
+        index.vectors.push_back(vector);
+        buffers.emplace_back();
+        return vector.id;
+    }
+
+    void Writer::setAttribute(uint32_t id, const std::string& key, const std::string& value)
+    {
+        index.vectors[id].attributes[key] = value;
+    }
+
+    void Writer::record(uint32_t id, int64_t time, double value)
+    {
+        VectorInfo& vector = index.vectors[id];
+        if (vector.samples == 0)
+            vector.min = vector.max = value;
+        vector.min = std::min(vector.min, value);
+        vector.max = std::max(vector.max, value);
+        vector.sum += value;
+        vector.samples++;
+
+        Buffer& buffer = buffers[id];
+        buffer.times.push_back(time);
+        buffer.values.push_back(value);
+        if (buffer.times.size() >= blockSize)
+            writeBlock(id);
+    }
+
+    void Writer::writeBlock(uint32_t id)
+    {
+        Buffer& buffer = buffers[id];
+        if (buffer.times.empty())
+            return;
+
+        BlockInfo block;
+        block.offset = offset;
+        block.samples = buffer.times.size();
+        block.firstTime = buffer.times.front();
+        block.lastTime = buffer.times.back();
+        write(encodeBlock(id, buffer.times, buffer.values, flags));
+        index.vectors[id].blocks.push_back(block);
+        buffer.times.clear();
+        buffer.values.clear();
+    }
+
+    void Writer::write(const std::string& bytes)
+    {
+        if (fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size())
+            throw std::runtime_error("cannot write " + fileName);
+        offset += bytes.size();
+    }
+
+    void Writer::flush()
+    {
+        if (file)
+            fflush(file);
+    }
+
+    void Writer::close()
+    {
+        if (!file)
+            return;
+        for (uint32_t id = 0; id < buffers.size(); id++)
+            writeBlock(id);
+
+        uint64_t indexOffset = offset;
+        std::string trailer = encodeIndex(index);
+        putFixed(trailer, indexOffset, 8);
+        trailer.append(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        write(trailer);
+
+        int result = fclose(file);
+        file = nullptr;
+        if (result != 0)
+            throw std::runtime_error("cannot write " + fileName);
+    }
+}
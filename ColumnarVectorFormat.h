@@ -0,0 +1,154 @@
+/*
+ * ColumnarVectorFormat.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ *
+ * Compact columnar file for output vectors (.cvec), written by
+ * ColumnarOutputVectorManager and read by tools/cvec and
+ * analysis/columnarVectors.py. It does not depend on OMNeT++.
+ *
+ * Layout (integers are little endian, "varint" is LEB128, signed varints
+ * are zigzag encoded):
+ *
+ *   header   "SDSCVEC" + '\0', u32 version
+ *   blocks   u32 vector id, u32 samples, u8 flags (FLOAT32, DEFLATE),
+ *            u32 stored time bytes, u32 stored value bytes,
+ *            [u32 raw time bytes, u32 raw value bytes if DEFLATE],
+ *            time column: signed varint deltas of the raw simtime values
+ *            (the first one from 0), value column: float32 or float64
+ *   index    signed varint simtime scale exponent, varint run attribute
+ *            count, (string key, string value)..., varint vector count, then
+ *            per vector: varint id, string module, string name, varint
+ *            attribute count, (string key, string value)..., u8 flags,
+ *            varint samples, f64 min, f64 max, f64 sum, varint block count,
+ *            (varint offset, varint samples, signed varint first time,
+ *            signed varint last time) per block
+ *   trailer  u64 index offset, "SDSCVIDX"
+ *
+ * Strings are a varint length followed by the bytes. Blocks of a vector
+ * are in time order; blocks of different vectors are interleaved in the
+ * order they were filled, so a reader seeks to the blocks it needs only.
+ */
+
+#ifndef COLUMNARVECTORFORMAT_H_
+#define COLUMNARVECTORFORMAT_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ColumnarVectorFormat
+{
+    const char FILE_MAGIC[8] = { 'S', 'D', 'S', 'C', 'V', 'E', 'C', '\0' };
+    const char INDEX_MAGIC[8] = { 'S', 'D', 'S', 'C', 'V', 'I', 'D', 'X' };
+    const uint32_t VERSION = 1;
+
+    // block flags
+    const uint8_t FLOAT32 = 1;
+    const uint8_t DEFLATE = 2;
+
+    struct BlockInfo {
+        uint64_t offset;
+        uint64_t samples;
+        int64_t firstTime;
+        int64_t lastTime;
+    };
+
+    struct VectorInfo {
+        uint32_t id;
+        std::string module;
+        std::string name;
+        std::map<std::string, std::string> attributes;
+        uint8_t flags;
+        uint64_t samples;
+        double min;
+        double max;
+        double sum;
+        std::vector<BlockInfo> blocks;
+    };
+
+    struct Index {
+        int scaleExp;
+        std::map<std::string, std::string> runAttributes;
+        std::vector<VectorInfo> vectors;
+    };
+
+    void putVarint(std::string& out, uint64_t value);
+    void putSignedVarint(std::string& out, int64_t value);
+    void putFixed(std::string& out, uint64_t value, int bytes);
+    void putDouble(std::string& out, double value);
+    void putString(std::string& out, const std::string& value);
+
+    /**
+     * Bounds-checked cursor over a byte range; throws std::runtime_error when
+     * the data is truncated.
+     */
+    class Cursor
+    {
+        private:
+            const unsigned char *position;
+            const unsigned char *end;
+
+        public:
+            Cursor(const void *data, size_t size) : position((const unsigned char *)data), end(position + size) {}
+
+            uint64_t getVarint();
+            int64_t getSignedVarint();
+            uint64_t getFixed(int bytes);
+            double getDouble();
+            float getFloat();
+            std::string getString();
+            const unsigned char *take(size_t bytes);
+            size_t remaining() const { return end - position; }
+    };
+
+    // encodes the samples of one block, times as raw simtime values
+    std::string encodeBlock(uint32_t vectorId, const std::vector<int64_t>& times, const std::vector<double>& values, uint8_t flags);
+    // decodes the block at data (of at most size bytes), appending its samples
+    void decodeBlock(const void *data, size_t size, std::vector<int64_t>& times, std::vector<double>& values);
+
+    std::string encodeIndex(const Index& index);
+    Index decodeIndex(const void *data, size_t size);
+
+    /**
+     * Appends blocks to a .cvec file, buffering blockSize samples per vector,
+     * and writes the index when closed.
+     */
+    class Writer
+    {
+        private:
+            struct Buffer {
+                std::vector<int64_t> times;
+                std::vector<double> values;
+            };
+
+            FILE *file;
+            std::string fileName;
+            uint64_t offset;
+            size_t blockSize;
+            uint8_t flags;
+            Index index;
+            std::vector<Buffer> buffers;
+
+            void write(const std::string& bytes);
+            void writeBlock(uint32_t id);
+
+        public:
+            Writer(size_t blockSize, bool float32, bool deflate);
+            ~Writer();
+
+            void open(const std::string& fileName, int scaleExp, const std::map<std::string, std::string>& runAttributes);
+            bool isOpen() const { return file != nullptr; }
+            uint32_t addVector(const std::string& module, const std::string& name);
+            void setAttribute(uint32_t id, const std::string& key, const std::string& value);
+            void record(uint32_t id, int64_t time, double value);
+            void flush();
+            // writes the remaining blocks and the index
+            void close();
+    };
+}
+
+#endif /* COLUMNARVECTORFORMAT_H_ */
@@ -0,0 +1,127 @@
+/*
+ * ConnectivityProcess.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "ConnectivityProcess.h"
+#include "OffloadingQueue.h"
+
+Define_Module(ConnectivityProcess);
+
+ConnectivityProcess::ConnectivityProcess()
+{
+    wifiStatusMsg = nullptr;
+}
+
+ConnectivityProcess::~ConnectivityProcess()
+{
+    cancelAndDelete(wifiStatusMsg);
+}
+
+void ConnectivityProcess::subscribe(OffloadingQueue *queue)
+{
+    Enter_Method("subscribe()");
+    queues.push_back(queue);
+}
+
+void ConnectivityProcess::initialize()
+{
+    wifiActiveTime = registerSignal("wifiActiveTime");
+    cellActiveTime = registerSignal("cellActiveTime");
+
+    // same initial state as a queue with its own process
+    wifiAvailable = false;
+    wifiStatusMsg = new cMessage("wifi_status_changed");
+    wifiStateVariate.initialize(this, "wifiStateDistribution");
+    cellularStateVariate.initialize(this, "cellularStateDistribution");
+    trace.initialize(this, "traceFile", "recordTrace");
+    updateNextStatusChangeTime();
+    WATCH(wifiAvailable);
+}
+
+void ConnectivityProcess::updateNextStatusChangeTime()
+{
+    simtime_t nextChange;
+    if (trace.isReplaying()) {
+        simtime_t changeTime;
+        if (!trace.nextWifiChange(!wifiAvailable, changeTime)) {
+            // as in OffloadingQueue: the queues never resume a suspended service
+            nextStatusChangeTime = SimTime::getMaxTime();
+            EV << "End of the connectivity trace, WIFI stays " << (wifiAvailable ? "ON" : "OFF") << endl;
+            return;
+        }
+        nextChange = changeTime - simTime();
+    }
+    else
+        nextChange = (wifiAvailable) ? wifiStateVariate.draw() : cellularStateVariate.draw();
+    if (wifiAvailable) emit(wifiActiveTime, nextChange);
+    else emit(cellActiveTime, nextChange);
+    nextStatusChangeTime = simTime() + nextChange;
+    scheduleAt(nextStatusChangeTime, wifiStatusMsg);
+    EV_DEBUG << "Next WIFI status change time: " << nextStatusChangeTime << endl;
+}
+
+void ConnectivityProcess::handleMessage(cMessage *msg)
+{
+    ASSERT(msg == wifiStatusMsg);
+
+    // the queues need the end of the new period to postpone suspended services
+    wifiAvailable = !wifiAvailable;
+    trace.recordWifiChange(wifiAvailable, simTime());
+    updateNextStatusChangeTime();
+    EV_DEBUG << "WIFI STATUS CHANGED! Now is " << (wifiAvailable ? "ON" : "OFF") << " for " << queues.size() << " queues\n";
+
+    for (OffloadingQueue *queue : queues)
+        queue->changeWifiStatus(wifiAvailable, nextStatusChangeTime);
+}
+
+void ConnectivityProcess::recordWifiAfterEnd()
+{
+    // as in OffloadingQueue: replays may last longer than this run
+    if (!trace.isRecording() || trace.isReplaying() || !wifiStatusMsg->isScheduled())
+        return;
+    simtime_t end = simTime() + par("recordTraceMargin");
+    bool available = wifiAvailable;
+    for (simtime_t changeTime = nextStatusChangeTime; changeTime <= end; ) {
+        available = !available;
+        trace.recordWifiChange(available, changeTime);
+        changeTime += available ? wifiStateVariate.draw() : cellularStateVariate.draw();
+    }
+}
+
+void ConnectivityProcess::finish()
+{
+    recordWifiAfterEnd();
+    trace.finish();
+}
+
+void ConnectivityProcess::refreshDisplay() const
+{
+    getDisplayString().setTagArg("i", 1, wifiAvailable ? "lime" : "red");
+}
+
+void ConnectivityProcess::saveState(SnapshotWriter& out)
+{
+    if (trace.isReplaying())
+        throw cRuntimeError("Snapshots of runs replaying a trace are not supported");
+    // the subscribed queues save their own copy of the status
+    out.writeBool(wifiAvailable);
+    out.writeTimer(wifiStatusMsg);
+    wifiStateVariate.saveState(out);
+    cellularStateVariate.saveState(out);
+}
+
+void ConnectivityProcess::restoreState(SnapshotReader& in)
+{
+    Enter_Method_Silent();
+    if (trace.isReplaying())
+        throw cRuntimeError("Snapshots of runs replaying a trace are not supported");
+    wifiAvailable = in.readBool();
+    cancelEvent(wifiStatusMsg);
+    if (in.readTimer(nextStatusChangeTime))
+        scheduleAt(nextStatusChangeTime, wifiStatusMsg);
+    wifiStateVariate.restoreState(in);
+    cellularStateVariate.restoreState(in);
+}
@@ -0,0 +1,59 @@
+/*
+ * ConnectivityProcess.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef CONNECTIVITYPROCESS_H_
+#define CONNECTIVITYPROCESS_H_
+
+#include <vector>
+
+#include "QueueingDefs.h"
+#include "Snapshot.h"
+#include "BatchedVariate.h"
+#include "TraceStream.h"
+
+class OffloadingQueue;
+
+/**
+ * WiFi on/off process shared by several OffloadingQueues, so that all of
+ * them see the same availability periods. See NED file for more info.
+ */
+class QUEUEING_API ConnectivityProcess : public cSimpleModule, public Checkpointable
+{
+    private:
+        simsignal_t wifiActiveTime;
+        simsignal_t cellActiveTime;
+
+        cMessage *wifiStatusMsg;
+        bool wifiAvailable;
+        simtime_t nextStatusChangeTime;
+        std::vector<OffloadingQueue *> queues;
+        BatchedVariate wifiStateVariate;
+        BatchedVariate cellularStateVariate;
+        TraceStream trace;
+
+        void updateNextStatusChangeTime();
+        void recordWifiAfterEnd();
+
+    public:
+        ConnectivityProcess();
+        virtual ~ConnectivityProcess();
+
+        // the queue is told about every change from now on; it may be called
+        // before this module is initialized, WiFi is off at the beginning
+        void subscribe(OffloadingQueue *queue);
+
+        virtual void saveState(SnapshotWriter& out) override;
+        virtual void restoreState(SnapshotReader& in) override;
+
+    protected:
+        virtual void initialize() override;
+        virtual void handleMessage(cMessage *msg) override;
+        virtual void finish() override;
+        virtual void refreshDisplay() const override;
+};
+
+#endif /* CONNECTIVITYPROCESS_H_ */
@@ -0,0 +1,130 @@
+/*
+ * EventProfile.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "EventProfile.h"
+
+#include <algorithm>
+#include <iostream>
+
+Register_PerRunConfigOption(CFGID_PROFILE_EVENTS, "profile-events", CFG_BOOL, "false", "Record the events, handler time and emit time of the profiled modules as profile:* scalars (see EventProfile)");
+Register_PerRunConfigOption(CFGID_PROFILE_SAMPLE_INTERVAL, "profile-sample-interval", CFG_INT, "16", "The clock is read on one event of a profiled module every this many, and the times are scaled up");
+Register_PerRunConfigOption(CFGID_PROFILE_PROGRESS_INTERVAL, "profile-progress-interval", CFG_DOUBLE, "0", "Wall-clock seconds between the progress lines with the profiles of all the modules (0 disables them)");
+
+std::vector<EventProfile *> EventProfile::profiles;
+double EventProfile::progressInterval = 0.0;
+EventProfile::Clock::time_point EventProfile::lastProgress;
+
+EventProfile::EventProfile()
+{
+    owner = nullptr;
+    enabled = false;
+    sampling = false;
+    sampleInterval = untilSample = 1;
+    emits = 0;
+    sampledEmitTime = Clock::duration::zero();
+    maxQueueLength = -1;
+    maxFesLength = 0;
+}
+
+EventProfile::~EventProfile()
+{
+    profiles.erase(std::remove(profiles.begin(), profiles.end(), this), profiles.end());
+}
+
+void EventProfile::initialize(cComponent *owner, const std::vector<std::string>& typeNames)
+{
+    this->owner = owner;
+    cConfiguration *config = getEnvir()->getConfig();
+    enabled = config->getAsBool(CFGID_PROFILE_EVENTS);
+    sampleInterval = std::max(1L, config->getAsInt(CFGID_PROFILE_SAMPLE_INTERVAL));
+    untilSample = sampleInterval;
+
+    types.clear();
+    for (const std::string& name : typeNames)
+        types.push_back(TypeProfile{name, 0, 0, Clock::duration::zero()});
+
+    if (!enabled)
+        return;
+    if (profiles.empty()) {
+        progressInterval = config->getAsDouble(CFGID_PROFILE_PROGRESS_INTERVAL);
+        lastProgress = Clock::now();
+    }
+    profiles.push_back(this);
+}
+
+void EventProfile::endEvent(int type, Clock::duration elapsed)
+{
+    sampling = false;
+    types[type].sampledEvents++;
+    types[type].sampledTime += elapsed;
+
+    if (progressInterval > 0.0) {
+        Clock::time_point now = Clock::now();
+        if (std::chrono::duration<double>(now - lastProgress).count() >= progressInterval) {
+            lastProgress = now;
+            printProgress();
+        }
+    }
+}
+
+long EventProfile::getEvents() const
+{
+    long events = 0;
+    for (const TypeProfile& type : types)
+        events += type.events;
+    return events;
+}
+
+long EventProfile::getSampledEvents() const
+{
+    long events = 0;
+    for (const TypeProfile& type : types)
+        events += type.sampledEvents;
+    return events;
+}
+
+double EventProfile::estimateSeconds(Clock::duration sampled, long total, long samples) const
+{
+    if (samples == 0)
+        return 0.0;
+    return std::chrono::duration<double>(sampled).count() * total / samples;
+}
+
+void EventProfile::printProgress()
+{
+    // one line for the whole simulation, like the Cmdenv status lines
+    std::cout << "** Profile at t=" << simTime() << ":";
+    for (EventProfile *profile : profiles) {
+        Clock::duration sampledTime = Clock::duration::zero();
+        for (const TypeProfile& type : profile->types)
+            sampledTime += type.sampledTime;
+        long samples = profile->getSampledEvents();
+        double nsPerEvent = samples > 0 ? std::chrono::duration<double, std::nano>(sampledTime).count() / samples : 0.0;
+        std::cout << " " << profile->owner->getFullPath() << " " << profile->getEvents() << " ev " << (long)nsPerEvent << " ns/ev;";
+    }
+    std::cout << std::endl;
+}
+
+void EventProfile::record()
+{
+    if (!enabled)
+        return;
+
+    for (const TypeProfile& type : types) {
+        double seconds = estimateSeconds(type.sampledTime, type.events, type.sampledEvents);
+        owner->recordScalar(("profile:" + type.name + ":events").c_str(), type.events);
+        owner->recordScalar(("profile:" + type.name + ":handlerTime").c_str(), seconds, "s");
+        owner->recordScalar(("profile:" + type.name + ":nsPerEvent").c_str(), type.events > 0 ? seconds * 1e9 / type.events : 0.0, "ns");
+    }
+
+    // emits are only timed inside the sampled events
+    owner->recordScalar("profile:emits", emits);
+    owner->recordScalar("profile:emitTime", estimateSeconds(sampledEmitTime, getEvents(), getSampledEvents()), "s");
+    if (maxQueueLength >= 0)
+        owner->recordScalar("profile:maxQueueLength", maxQueueLength);
+    owner->recordScalar("profile:maxFesLength", maxFesLength);
+}
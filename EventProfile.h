@@ -0,0 +1,140 @@
+/*
+ * EventProfile.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef EVENTPROFILE_H_
+#define EVENTPROFILE_H_
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "QueueingDefs.h"
+
+/**
+ * Runtime profile of a module, enabled with profile-events = true: events
+ * by type (e.g. arrival, end_service), wall-clock time spent handling them
+ * and in the emits of the module (which includes the listeners and result
+ * recorders), peak queue length and peak future event set length. Counts and
+ * peaks are exact; the clock is only read on one event every profile-sample-interval
+ * and the times are scaled up from these samples, so the profile can stay
+ * enabled in production runs. The module records it as profile:* scalars at
+ * finish(); with profile-progress-interval the profiles of all the modules
+ * are also printed periodically.
+ *
+ * Time spent in another module called directly (e.g. a listener) is counted
+ * by both modules.
+ */
+class QUEUEING_API EventProfile
+{
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+        // profiles one event of the given type, from construction to destruction
+        class Scope
+        {
+            private:
+                EventProfile& profile;
+                int type;
+                bool timed;
+                Clock::time_point start;
+
+            public:
+                Scope(EventProfile& profile, int type) : profile(profile), type(type) {
+                    timed = profile.beginEvent(type);
+                    if (timed)
+                        start = Clock::now();
+                }
+                ~Scope() {
+                    if (timed)
+                        profile.endEvent(type, Clock::now() - start);
+                }
+        };
+
+        // profiles one emit; only timed inside a sampled event
+        class EmitScope
+        {
+            private:
+                EventProfile& profile;
+                Clock::time_point start;
+
+            public:
+                explicit EmitScope(EventProfile& profile) : profile(profile) {
+                    if (profile.sampling)
+                        start = Clock::now();
+                }
+                ~EmitScope() {
+                    if (profile.enabled)
+                        profile.endEmit(profile.sampling ? Clock::now() - start : Clock::duration::zero());
+                }
+        };
+
+    private:
+        struct TypeProfile {
+            std::string name;
+            long events;
+            long sampledEvents;
+            Clock::duration sampledTime;
+        };
+
+        cComponent *owner;
+        bool enabled;
+        bool sampling;
+        long sampleInterval;
+        long untilSample;
+        std::vector<TypeProfile> types;
+        long emits;
+        Clock::duration sampledEmitTime;
+        int maxQueueLength;
+        int maxFesLength;
+
+        static std::vector<EventProfile *> profiles;
+        static double progressInterval;
+        static Clock::time_point lastProgress;
+
+        bool beginEvent(int type) {
+            if (!enabled)
+                return false;
+            types[type].events++;
+            // peaks are exact too: reading the length is cheap
+            int fesLength = getSimulation()->getFES()->getLength();
+            if (fesLength > maxFesLength)
+                maxFesLength = fesLength;
+            if (--untilSample > 0)
+                return false;
+            untilSample = sampleInterval;
+            sampling = true;
+            return true;
+        }
+        void endEvent(int type, Clock::duration elapsed);
+        void endEmit(Clock::duration elapsed) {
+            emits++;
+            sampledEmitTime += elapsed;
+        }
+
+        long getEvents() const;
+        long getSampledEvents() const;
+        double estimateSeconds(Clock::duration sampled, long total, long samples) const;
+        void printProgress();
+
+    public:
+        EventProfile();
+        ~EventProfile();
+
+        // typeNames are the names of the event types, in the order of their indices
+        void initialize(cComponent *owner, const std::vector<std::string>& typeNames);
+        bool isEnabled() const { return enabled; }
+
+        void collectQueueLength(int length) {
+            if (length > maxQueueLength)
+                maxQueueLength = length;
+        }
+
+        // records the profile:* scalars of the owner
+        void record();
+};
+
+#endif /* EVENTPROFILE_H_ */
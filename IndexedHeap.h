@@ -0,0 +1,126 @@
+/*
+ * IndexedHeap.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef INDEXEDHEAP_H_
+#define INDEXEDHEAP_H_
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Binary heap of items ordered by a key, with a position index so that any
+ * item can be removed in O(log n). The item with the smallest key according
+ * to Compare is on top. Items must be unique and hashable (typically
+ * pointers).
+ */
+template <typename Item, typename Key, typename Compare = std::less<Key>>
+class IndexedHeap
+{
+    public:
+        struct Entry {
+            Key key;
+            Item item;
+        };
+
+    private:
+        std::vector<Entry> heap;
+        std::unordered_map<Item, std::size_t> positions;
+        Compare compare;
+
+        bool before(std::size_t a, std::size_t b) const { return compare(heap[a].key, heap[b].key); }
+
+        void place(std::size_t index, Entry&& entry) {
+            positions[entry.item] = index;
+            heap[index] = std::move(entry);
+        }
+
+        void siftUp(std::size_t index) {
+            Entry entry = std::move(heap[index]);
+            while (index > 0) {
+                std::size_t parent = (index - 1) / 2;
+                if (!compare(entry.key, heap[parent].key))
+                    break;
+                place(index, std::move(heap[parent]));
+                index = parent;
+            }
+            place(index, std::move(entry));
+        }
+
+        void siftDown(std::size_t index) {
+            std::size_t size = heap.size();
+            Entry entry = std::move(heap[index]);
+            while (true) {
+                std::size_t child = 2 * index + 1;
+                if (child >= size)
+                    break;
+                if (child + 1 < size && before(child + 1, child))
+                    child++;
+                if (!compare(heap[child].key, entry.key))
+                    break;
+                place(index, std::move(heap[child]));
+                index = child;
+            }
+            place(index, std::move(entry));
+        }
+
+        Item removeAt(std::size_t index) {
+            Item item = heap[index].item;
+            positions.erase(item);
+
+            std::size_t last = heap.size() - 1;
+            if (index != last) {
+                heap[index] = std::move(heap[last]);
+                heap.pop_back();
+                positions[heap[index].item] = index;
+                if (index > 0 && before(index, (index - 1) / 2))
+                    siftUp(index);
+                else
+                    siftDown(index);
+            }
+            else
+                heap.pop_back();
+            return item;
+        }
+
+    public:
+        explicit IndexedHeap(const Compare& compare = Compare()) : compare(compare) {}
+
+        void setCompare(const Compare& c) { compare = c; }
+
+        bool isEmpty() const { return heap.empty(); }
+        std::size_t getLength() const { return heap.size(); }
+        bool contains(const Item& item) const { return positions.find(item) != positions.end(); }
+
+        const Item& front() const { return heap.front().item; }
+        const Key& frontKey() const { return heap.front().key; }
+        const Key& getKey(const Item& item) const { return heap[positions.at(item)].key; }
+
+        void insert(const Item& item, const Key& key) {
+            heap.push_back(Entry{key, item});
+            positions[item] = heap.size() - 1;
+            siftUp(heap.size() - 1);
+        }
+
+        Item pop() { return removeAt(0); }
+
+        // removes the item, which must be in the heap
+        Item remove(const Item& item) { return removeAt(positions.at(item)); }
+
+        void clear() {
+            heap.clear();
+            positions.clear();
+        }
+
+        // entries in heap (not sorted) order
+        typename std::vector<Entry>::const_iterator begin() const { return heap.begin(); }
+        typename std::vector<Entry>::const_iterator end() const { return heap.end(); }
+};
+
+#endif /* INDEXEDHEAP_H_ */
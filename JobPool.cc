@@ -0,0 +1,50 @@
+/*
+ * JobPool.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "JobPool.h"
+
+#include <new>
+#include <typeinfo>
+
+JobPool::JobPool()
+{
+    hits = 0;
+    misses = 0;
+    released = 0;
+}
+
+JobPool::~JobPool()
+{
+    for (void *storage : freeList)
+        ::operator delete(storage);
+}
+
+void *JobPool::acquire()
+{
+    if (freeList.empty()) {
+        misses++;
+        return nullptr;
+    }
+
+    hits++;
+    void *storage = freeList.back();
+    freeList.pop_back();
+    return storage;
+}
+
+void JobPool::release(Job *job)
+{
+    // only plain jobs fit in the recycled storage
+    if (typeid(*job) != typeid(Job)) {
+        delete job;
+        return;
+    }
+
+    released++;
+    job->~Job();
+    freeList.push_back(job);
+}
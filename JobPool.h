@@ -0,0 +1,47 @@
+/*
+ * JobPool.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef JOBPOOL_H_
+#define JOBPOOL_H_
+
+#include <vector>
+
+#include "QueueingDefs.h"
+#include "Job.h"
+
+using namespace queueing;
+
+/**
+ * Free list of Job storage. Consumed jobs are destroyed but their memory is
+ * kept, so that the next job can be constructed in place without going
+ * through the allocator; constructing it again also resets every field
+ * (counters, accumulated times, timestamps, context pointer, creation time).
+ */
+class QUEUEING_API JobPool
+{
+    private:
+        std::vector<void *> freeList;
+        long hits;
+        long misses;
+        long released;
+
+    public:
+        JobPool();
+        ~JobPool();
+
+        // returns storage for a Job, or nullptr if the pool is empty
+        void *acquire();
+        // destroys the job and keeps its storage for reuse
+        void release(Job *job);
+
+        long getHits() const { return hits; }
+        long getMisses() const { return misses; }
+        long getReleased() const { return released; }
+        long getFreeCount() const { return freeList.size(); }
+};
+
+#endif /* JOBPOOL_H_ */
@@ -0,0 +1,70 @@
+/*
+ * JobReplicator.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "JobReplicator.h"
+#include "LimitedSource.h"
+
+#include <new>
+
+Define_Module(JobReplicator);
+
+JobReplicator::JobReplicator()
+{
+    jobPool = nullptr;
+}
+
+void JobReplicator::initialize()
+{
+    pipelines = gateSize("out");
+    completedPipelines = 0;
+    replicatedJobs = 0;
+    WATCH(completedPipelines);
+
+    wifiServiceTime.initialize(this, "wifiServiceTime");
+    cellularServiceTime.initialize(this, "cellularServiceTime");
+    remoteServiceTime.initialize(this, "remoteServiceTime");
+
+    // copies come back to the pool of the source, so they are taken from it too
+    jobPool = nullptr;
+    if (par("recycleJobs").boolValue())
+        jobPool = check_and_cast<LimitedSource *>(getModuleByPath(par("sourceModule")))->getJobPool();
+}
+
+void JobReplicator::handleMessage(cMessage *msg)
+{
+    Job *job = check_and_cast<Job *>(msg);
+
+    job->addPar("wifiServiceTime").setDoubleValue(wifiServiceTime.draw());
+    job->addPar("cellularServiceTime").setDoubleValue(cellularServiceTime.draw());
+    job->addPar("remoteServiceTime").setDoubleValue(remoteServiceTime.draw());
+
+    for (int i = 1; i < pipelines; i++)
+        send(copyJob(job), "out", i);
+    send(job, "out", 0);
+    replicatedJobs++;
+}
+
+Job *JobReplicator::copyJob(Job *job)
+{
+    void *storage = jobPool ? jobPool->acquire() : nullptr;
+    if (!storage)
+        return job->dup();
+    return new (storage) Job(*job);
+}
+
+void JobReplicator::pipelineCompleted()
+{
+    Enter_Method("pipelineCompleted()");
+    if (++completedPipelines == pipelines)
+        endSimulation();
+}
+
+void JobReplicator::finish()
+{
+    recordScalar("replicatedJobs", replicatedJobs);
+    recordScalar("completedPipelines", completedPipelines);
+}
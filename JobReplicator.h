@@ -0,0 +1,49 @@
+/*
+ * JobReplicator.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef JOBREPLICATOR_H_
+#define JOBREPLICATOR_H_
+
+#include "QueueingDefs.h"
+#include "Job.h"
+#include "JobPool.h"
+#include "BatchedVariate.h"
+
+using namespace queueing;
+
+/**
+ * Sends a copy of every job to each output, after drawing its service
+ * times once for all the copies (common random numbers). The simulation
+ * ends when every pipeline has reported that it is complete. See NED file
+ * for more info.
+ */
+class QUEUEING_API JobReplicator : public cSimpleModule
+{
+    private:
+        JobPool *jobPool;
+        int pipelines;
+        int completedPipelines;
+        long replicatedJobs;
+        BatchedVariate wifiServiceTime;
+        BatchedVariate cellularServiceTime;
+        BatchedVariate remoteServiceTime;
+
+        Job *copyJob(Job *job);
+
+    public:
+        JobReplicator();
+
+        // called once by the sink of every pipeline when it has all its jobs
+        void pipelineCompleted();
+
+    protected:
+        virtual void initialize() override;
+        virtual void handleMessage(cMessage *msg) override;
+        virtual void finish() override;
+};
+
+#endif /* JOBREPLICATOR_H_ */
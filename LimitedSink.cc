@@ -6,11 +6,30 @@
  */
 
 #include "LimitedSink.h"
+#include "LimitedSource.h"
+#include "JobReplicator.h"
+#include "OffloadingQueue.h"
+#include "QueueCustom.h"
 #include "Job.h"
 
+#include <cmath>
+
 
 Define_Module(LimitedSink);
 
+LimitedSink::LimitedSink()
+{
+    responseTimeHistogram = nullptr;
+    jobPool = nullptr;
+    jobSource = nullptr;
+    completionModule = nullptr;
+}
+
+LimitedSink::~LimitedSink()
+{
+    delete responseTimeHistogram;
+}
+
 void LimitedSink::initialize()
 {
     lifeTimeSignal = registerSignal("lifeTime");
@@ -23,15 +42,130 @@ void LimitedSink::initialize()
     keepJobs = par("keepJobs");
 
     totalResponseTime = registerSignal("totalResponseTime");
+    profile.initialize(this, { "arrival", "signal:jobServiceTime", "signal:wifiStatus" });
 
     jobCounter = 0;
     WATCH(jobCounter);
+
+    jobPool = nullptr;
+    jobSource = nullptr;
+    bool recycleJobs = par("recycleJobs").boolValue() && !keepJobs;
+    autoWarmup = par("autoWarmup");
+    regenerative = par("regenerative");
+    if (recycleJobs || autoWarmup || regenerative)
+        jobSource = check_and_cast<LimitedSource *>(getModuleByPath(par("sourceModule")));
+
+    if (recycleJobs) {
+        // a pool nobody takes from would only grow
+        if (!jobSource->par("recycleJobs").boolValue())
+            throw cRuntimeError("recycleJobs is set on the sink but not on %s", jobSource->getFullPath().c_str());
+        jobPool = jobSource->getJobPool();
+    }
+
+    streamingStatistics = par("streamingStatistics");
+    if (streamingStatistics) {
+        erwpExponents = cStringTokenizer(par("erwpExponents")).asDoubleVector();
+        responseTimeStats.clear();
+        responseTimeHistogram = new cPSquare("responseTime", par("histogramBins").intValue());
+        energyStats.clear();
+
+        // service times are emitted by the queues, which are our siblings,
+        // unless the queues stamp the energy on the jobs instead
+        energyAttributes = cStringTokenizer(par("energyAttributes")).asVector();
+        jobServiceTimeSignal = registerSignal("jobServiceTime");
+        cellularServiceTimeSignal = registerSignal("cellularServiceTime");
+        if (energyAttributes.empty()) {
+            getParentModule()->subscribe(jobServiceTimeSignal, this);
+            // cellular service times of a MultiDeviceOffloading module
+            getParentModule()->subscribe(cellularServiceTimeSignal, this);
+        }
+    }
+
+    numBatches = par("numBatches");
+    batchSize = par("batchSize");
+    if (numBatches > 0 && !streamingStatistics)
+        throw cRuntimeError("batch means (numBatches > 0) require streamingStatistics");
+    // a service signal goes to the batch open at the time of the service,
+    // which may not be the one of the departure of the job
+    if (numBatches > 0 && energyAttributes.empty())
+        throw cRuntimeError("batch means (numBatches > 0) require energyAttributes, so that every batch has the energy of its own jobs");
+    batches.clear();
+    batches.reserve(numBatches);
+    currentBatch = BatchTotals();
+
+    warmupDetected = false;
+    truncationFound = false;
+    if (autoWarmup) {
+        if (getSimulation()->getWarmupPeriod() != 0.0)
+            throw cRuntimeError("autoWarmup replaces warmup-period, set it to 0s");
+        warmupDetector.setBatchSize(par("warmupBatchSize"));
+        warmupCheckInterval = par("warmupCheckInterval");
+        nextWarmupCheck = par("warmupMinBatches");
+        warmupMaxJobs = par("warmupMaxJobs").intValue();
+        WATCH(warmupDetected);
+    }
+
+    completed = false;
+    restored = false;
+    completionModule = nullptr;
+    if (!par("completionModule").stdstringValue().empty()) {
+        // the source is shared by all the pipelines
+        if (autoWarmup)
+            throw cRuntimeError("autoWarmup cannot be used with a completionModule");
+        completionModule = check_and_cast<JobReplicator *>(getModuleByPath(par("completionModule")));
+    }
+
+    regenerationStarted = false;
+    currentCycle = BatchTotals();
+    cycleTotals.setDimension(4);
+    cycleLengths.clear();
+    currentWeightedCycle = WeightedTotals();
+    weightedCycleTotals.setDimension(3);
+    cycleLikelihoodRatios.clear();
+
+    // the queues are our siblings, the WiFi status is emitted by the OffloadingQueue
+    offloadingQueues.clear();
+    customQueues.clear();
+    importanceSampling = false;
+    for (cModule::SubmoduleIterator it(getParentModule()); !it.end(); ++it) {
+        if (OffloadingQueue *queue = dynamic_cast<OffloadingQueue *>(*it)) {
+            offloadingQueues.push_back(queue);
+            importanceSampling |= queue->par("importanceSampling").boolValue();
+        }
+        else if (QueueCustom *queue = dynamic_cast<QueueCustom *>(*it))
+            customQueues.push_back(queue);
+    }
+    // the likelihood ratio restarts at every cycle, its weights only apply to cycle totals
+    if (importanceSampling && !regenerative)
+        throw cRuntimeError("importance sampling in the queues requires a regenerative sink");
+
+    if (regenerative) {
+        if (!streamingStatistics)
+            throw cRuntimeError("regenerative mode requires streamingStatistics");
+        if (numBatches > 0 || autoWarmup || completionModule)
+            throw cRuntimeError("regenerative mode cannot be used with batch means, autoWarmup or a completionModule");
+        if (getSimulation()->getWarmupPeriod() != 0.0)
+            throw cRuntimeError("regenerative mode needs no warmup, set warmup-period to 0s");
+        regenerationCycles = par("regenerationCycles");
+        wifiStatusSignal = registerSignal("wifiStatus");
+        getParentModule()->subscribe(wifiStatusSignal, this);
+        WATCH(regenerationStarted);
+    }
 }
 
 void LimitedSink::handleMessage(cMessage *msg)
 {
+    EventProfile::Scope scope(profile, ARRIVAL_EVENT);
     Job *job = check_and_cast<Job *>(msg);
 
+    if (completed) {
+        releaseJob(job);
+        return;
+    }
+
+    if (autoWarmup && !warmupDetected)
+        checkWarmup(job);
+
     if (job->getKind() == 1)
         jobCounter++;
 
@@ -46,18 +180,416 @@ void LimitedSink::handleMessage(cMessage *msg)
         emit(totalDelayTimeSignal, job->getTotalDelayTime());
         emit(delaysVisitedSignal, job->getDelayCount());
         emit(generationSignal, job->getGeneration());
+
+        if (streamingStatistics) {
+            // before the job, as the signals of its services would have been
+            for (const std::string& attribute : energyAttributes)
+                if (job->hasPar(attribute.c_str()))
+                    collectEnergy(job->par(attribute.c_str()).doubleValue());
+
+            double responseTime = (job->getTotalQueueingTime() + job->getTotalServiceTime()).dbl();
+            responseTimeStats.collect(responseTime);
+            responseTimeHistogram->collect(responseTime);
+
+            if (numBatches > 0) {
+                currentBatch.responseTimeSum += responseTime;
+                if (++currentBatch.jobs == batchSize)
+                    closeBatch();
+            }
+            if (regenerative) {
+                currentCycle.responseTimeSum += responseTime;
+                currentCycle.jobs++;
+            }
+            if (importanceSampling) {
+                // the likelihood ratio of everything drawn in the cycle up to now
+                double weight = likelihoodRatio();
+                currentWeightedCycle.responseTimeSum += weight * responseTime;
+                currentWeightedCycle.jobs += weight;
+                if (job->hasPar("reneged"))
+                    currentWeightedCycle.reneged += weight;
+            }
+        }
     }
 
-    if (!keepJobs)
-        delete msg;
+    releaseJob(job);
 
-    if (jobCounter >= par("numJobs").intValue() && getSimulation()->getWarmupPeriod() != 0.0)
+    if (numBatches > 0) {
+        if ((int)batches.size() >= numBatches)
+            complete();
+    }
+    // a regenerative run ends at a regeneration point
+    else if (!regenerative && jobCounter >= par("numJobs").intValue() && (getSimulation()->getWarmupPeriod() != 0.0 || warmupDetected || restored))
+        complete();
+}
+
+void LimitedSink::releaseJob(Job *job)
+{
+    if (jobPool)
+        jobPool->release(job);
+    else if (!keepJobs)
+        delete job;
+}
+
+void LimitedSink::complete()
+{
+    if (!completionModule) {
         endSimulation();
+        return;
+    }
+
+    EV << "Pipeline complete at " << simTime() << endl;
+    completed = true;
+    completionModule->pipelineCompleted();
+}
+
+void LimitedSink::checkWarmup(Job *job)
+{
+    // jobs created before the switch are still unmeasured (kind 0)
+    if (job->getKind() == 1)
+        return;
+
+    warmupDetector.collect((job->getTotalQueueingTime() + job->getTotalServiceTime()).dbl(), simTime().dbl());
+
+    int batches = warmupDetector.getBatchCount();
+    if (warmupDetector.getObservationCount() >= warmupMaxJobs) {
+        EV_WARN << "No MSER truncation point after " << warmupMaxJobs << " jobs, ending warmup anyway" << endl;
+        endWarmup(-1);
+    }
+    else if (batches >= nextWarmupCheck) {
+        nextWarmupCheck = batches + warmupCheckInterval;
+        int truncation = warmupDetector.computeTruncation();
+        if (truncation >= 0)
+            endWarmup(truncation);
+    }
+}
+
+void LimitedSink::endWarmup(int truncation)
+{
+    warmupDetected = true;
+    truncationFound = truncation >= 0;
+    warmupSwitchTime = simTime();
+    if (truncationFound) {
+        // MSER drops batches 0..truncation-1: the kept data starts at the end of the last dropped one
+        truncationTime = truncation > 0 ? SimTime(warmupDetector.getBatchEndTime(truncation - 1)) : SIMTIME_ZERO;
+        truncationJobs = (long)truncation * par("warmupBatchSize").intValue();
+    }
+    else {
+        truncationTime = simTime();
+        truncationJobs = warmupDetector.getObservationCount();
+    }
+    EV << "Warmup over: MSER truncation at " << truncationTime << " (" << truncationJobs << " jobs), measuring from " << warmupSwitchTime << endl;
+    jobSource->endWarmup();
+}
+
+void LimitedSink::saveState(SnapshotWriter& out)
+{
+    // snapshots are taken during the warmup, when nothing is measured yet
+    out.writeInt(jobCounter);
+}
+
+void LimitedSink::restoreState(SnapshotReader& in)
+{
+    Enter_Method_Silent();
+    if (autoWarmup)
+        throw cRuntimeError("autoWarmup cannot be used with a snapshot, which is taken at the end of a fixed warmup");
+    if (regenerative)
+        throw cRuntimeError("regenerative mode cannot be used with a snapshot, it starts at the first regeneration point");
+    jobCounter = in.readInt();
+    restored = true;
+}
+
+void LimitedSink::receiveSignal(cComponent *source, simsignal_t signalID, const SimTime& t, cObject *details)
+{
+    // queues only emit service times of measured jobs
+    EventProfile::Scope scope(profile, SERVICE_TIME_SIGNAL);
+    if (completed)
+        return;
+
+    double coefficient = getPowerCoefficient(source, signalID);
+    if (coefficient > 0.0)
+        collectEnergy(coefficient * t.dbl());
+}
+
+void LimitedSink::collectEnergy(double energy)
+{
+    energyStats.collect(energy);
+    if (numBatches > 0) {
+        currentBatch.energySum += energy;
+        currentBatch.energyCount++;
+    }
+    if (regenerative) {
+        currentCycle.energySum += energy;
+        currentCycle.energyCount++;
+    }
+}
+
+void LimitedSink::receiveSignal(cComponent *source, simsignal_t signalID, bool b, cObject *details)
+{
+    // WiFi turning on in an empty system: the inter-arrival times are
+    // exponential and a new WiFi period starts, so nothing depends on the past
+    EventProfile::Scope scope(profile, WIFI_STATUS_SIGNAL);
+    if (!completed && b && isSystemEmpty())
+        regeneration();
+}
+
+bool LimitedSink::isSystemEmpty() const
+{
+    for (OffloadingQueue *queue : offloadingQueues)
+        if (!queue->isEmpty())
+            return false;
+    for (QueueCustom *queue : customQueues)
+        if (!queue->isEmpty())
+            return false;
+    return true;
+}
+
+void LimitedSink::regeneration()
+{
+    if (!regenerationStarted) {
+        // the jobs created before have all left: measure from here
+        regenerationStarted = true;
+        firstRegeneration = simTime();
+        cycleStart = simTime();
+        EV << "First regeneration point at " << simTime() << ", measuring from here" << endl;
+        jobSource->endWarmup();
+    }
+    else {
+        cycleTotals.collect({ currentCycle.responseTimeSum, (double)currentCycle.jobs, currentCycle.energySum, (double)currentCycle.energyCount });
+        currentCycle = BatchTotals();
+        if (importanceSampling) {
+            weightedCycleTotals.collect({ currentWeightedCycle.responseTimeSum, currentWeightedCycle.jobs, currentWeightedCycle.reneged });
+            currentWeightedCycle = WeightedTotals();
+            cycleLikelihoodRatios.collect(likelihoodRatio());
+        }
+        cycleLengths.collect((simTime() - cycleStart).dbl());
+        cycleStart = simTime();
+    }
+
+    for (OffloadingQueue *queue : offloadingQueues)
+        queue->resetLikelihoodRatio();
+    if (cycleTotals.getCount() >= regenerationCycles)
+        complete();
+}
+
+double LimitedSink::likelihoodRatio() const
+{
+    double logRatio = 0.0;
+    for (OffloadingQueue *queue : offloadingQueues)
+        logRatio += queue->getLogLikelihoodRatio();
+    return std::exp(logRatio);
+}
+
+double LimitedSink::getPowerCoefficient(cComponent *source, simsignal_t signalID)
+{
+    auto key = std::make_pair(source->getId(), signalID);
+    auto it = powerCoefficients.find(key);
+    if (it != powerCoefficients.end())
+        return it->second;
+
+    // a MultiDeviceOffloading has one coefficient per interface
+    const char *name = signalID == cellularServiceTimeSignal ? "cellularPowerCoefficient" : "powerCoefficient";
+    double coefficient = source->hasPar(name) ? source->par(name).doubleValue() : 0.0;
+    powerCoefficients[key] = coefficient;
+    return coefficient;
+}
+
+void LimitedSink::closeBatch()
+{
+    batches.push_back(currentBatch);
+    currentBatch = BatchTotals();
+    EV << "Closed batch " << batches.size() << " of " << numBatches << endl;
+}
+
+double LimitedSink::batchResponseAutocorrelation() const
+{
+    RunningStatistic means;
+    for (const BatchTotals& batch : batches)
+        means.collect(batch.responseTimeSum / batch.jobs);
+
+    double numerator = 0.0;
+    double denominator = 0.0;
+    for (size_t i = 0; i < batches.size(); i++) {
+        double deviation = batches[i].responseTimeSum / batches[i].jobs - means.getMean();
+        denominator += deviation * deviation;
+        if (i + 1 < batches.size())
+            numerator += deviation * (batches[i + 1].responseTimeSum / batches[i + 1].jobs - means.getMean());
+    }
+    return denominator > 0.0 ? numerator / denominator : 0.0;
+}
+
+void LimitedSink::mergeBatchPairs()
+{
+    // an odd last batch is dropped so that all batches keep the same size
+    std::vector<BatchTotals> merged;
+    for (size_t i = 0; i + 1 < batches.size(); i += 2) {
+        BatchTotals batch = batches[i];
+        batch.responseTimeSum += batches[i + 1].responseTimeSum;
+        batch.jobs += batches[i + 1].jobs;
+        batch.energySum += batches[i + 1].energySum;
+        batch.energyCount += batches[i + 1].energyCount;
+        merged.push_back(batch);
+    }
+    batches.swap(merged);
+    batchSize *= 2;
+}
+
+void LimitedSink::recordBatchMeans()
+{
+    // correlated batches make the intervals too narrow: grow the batches
+    // while the lag-1 autocorrelation of the batch MRTs is too high
+    double maxCorrelation = par("maxBatchCorrelation");
+    int minBatches = par("minBatches");
+    double correlation = batchResponseAutocorrelation();
+    if (maxCorrelation >= 0) {
+        while (std::fabs(correlation) > maxCorrelation && (int)batches.size() / 2 >= minBatches) {
+            mergeBatchPairs();
+            correlation = batchResponseAutocorrelation();
+        }
+        if (std::fabs(correlation) > maxCorrelation)
+            EV_WARN << "Batch MRT lag-1 autocorrelation " << correlation << " still above " << maxCorrelation << ", use larger batches" << endl;
+    }
+
+    RunningStatistic mrtBatches;
+    RunningStatistic mecBatches;
+    std::vector<RunningStatistic> erwpBatches(erwpExponents.size());
+    for (const BatchTotals& batch : batches) {
+        double mrt = OffloadingMetrics::meanResponseTime(batch.responseTimeSum, batch.jobs);
+        double mec = OffloadingMetrics::meanEnergyConsumption(batch.energySum, batch.energyCount);
+        mrtBatches.collect(mrt);
+        mecBatches.collect(mec);
+        for (size_t i = 0; i < erwpExponents.size(); i++)
+            erwpBatches[i].collect(OffloadingMetrics::erwp(mec, mrt, erwpExponents[i]));
+    }
+
+    recordScalar("batches", batches.size());
+    recordScalar("batchSize", batchSize);
+    recordScalar("batchMRT:lag1Autocorrelation", correlation);
+
+    double confidence = par("batchConfidence");
+    auto recordBatchInterval = [&](const std::string& name, const RunningStatistic& values) {
+        recordScalar((name + ":batchMean").c_str(), values.getMean());
+        recordScalar((name + ":batchVariance").c_str(), values.getVariance());
+        recordScalar((name + ":batchHalfWidth").c_str(), OffloadingMetrics::confidenceHalfWidth(values, confidence));
+    };
+    recordBatchInterval("MRT", mrtBatches);
+    recordBatchInterval("MEC", mecBatches);
+    for (size_t i = 0; i < erwpExponents.size(); i++)
+        recordBatchInterval(OffloadingMetrics::erwpName(erwpExponents[i]), erwpBatches[i]);
+}
+
+void LimitedSink::recordInterval(const std::string& name, const char *method, double estimate, double variance, long samples)
+{
+    double confidence = par("regenerativeConfidence");
+    double t = OffloadingMetrics::studentTQuantile(0.5 + confidence / 2.0, samples - 1);
+    recordScalar((name + ":" + method + "Mean").c_str(), estimate);
+    recordScalar((name + ":" + method + "Variance").c_str(), variance);
+    recordScalar((name + ":" + method + "HalfWidth").c_str(), t * std::sqrt(variance));
+}
+
+void LimitedSink::recordRegenerativeEstimates()
+{
+    recordScalar("regeneration:cycles", cycleTotals.getCount());
+    recordScalar("regeneration:meanCycleLength", cycleLengths.getMean(), "s");
+    if (regenerationStarted)
+        recordScalar("regeneration:firstTime", firstRegeneration, "s");
+    if (cycleTotals.getCount() < 2) {
+        EV_WARN << "Fewer than 2 regeneration cycles, no confidence intervals recorded" << endl;
+        return;
+    }
+
+    // per-cycle totals of response time, jobs, energy and energy samples: the
+    // metrics are functions of their means, e.g. MRT = E[R] / E[N] / 60, and
+    // the delta method gives the variance of the estimators
+    enum { RESPONSE = 0, JOBS, ENERGY, ENERGY_COUNT, TOTALS };
+    const double minute = OffloadingMetrics::SECONDS_PER_MINUTE;
+    double jobs = cycleTotals.getMean(JOBS);
+    double energyCount = cycleTotals.getMean(ENERGY_COUNT);
+    double mrt = cycleTotals.getMean(RESPONSE) / jobs / minute;
+    double mec = cycleTotals.getMean(ENERGY) / energyCount / minute;
+    std::vector<double> mrtGradient = { 1.0 / (jobs * minute), -mrt / jobs, 0.0, 0.0 };
+    std::vector<double> mecGradient = { 0.0, 0.0, 1.0 / (energyCount * minute), -mec / energyCount };
+
+    long cycles = cycleTotals.getCount();
+    recordInterval("MRT", "regenerative", mrt, cycleTotals.deltaMethodVariance(mrtGradient), cycles);
+    recordInterval("MEC", "regenerative", mec, cycleTotals.deltaMethodVariance(mecGradient), cycles);
+    for (double w : erwpExponents) {
+        double erwp = OffloadingMetrics::erwp(mec, mrt, w);
+        std::vector<double> erwpGradient(TOTALS);
+        for (int i = 0; i < TOTALS; i++)
+            erwpGradient[i] = erwp * (w * mecGradient[i] / mec + (1.0 - w) * mrtGradient[i] / mrt);
+        recordInterval(OffloadingMetrics::erwpName(w), "regenerative", erwp, cycleTotals.deltaMethodVariance(erwpGradient), cycles);
+    }
+}
+
+void LimitedSink::recordImportanceSamplingEstimates()
+{
+    if (weightedCycleTotals.getCount() < 2)
+        return;
+
+    // same ratios over the weighted totals; the likelihood ratio of a whole
+    // cycle is 1 in expectation, far from it the tilt is too strong for the
+    // run length
+    enum { RESPONSE = 0, JOBS, RENEGED };
+    double weightedJobs = weightedCycleTotals.getMean(JOBS);
+    double mrt = weightedCycleTotals.getMean(RESPONSE) / weightedJobs / OffloadingMetrics::SECONDS_PER_MINUTE;
+    double reneging = weightedCycleTotals.getMean(RENEGED) / weightedJobs;
+    std::vector<double> mrtGradient = { 1.0 / (weightedJobs * OffloadingMetrics::SECONDS_PER_MINUTE), -mrt / weightedJobs, 0.0 };
+    std::vector<double> renegingGradient = { 0.0, -reneging / weightedJobs, 1.0 / weightedJobs };
+
+    long cycles = weightedCycleTotals.getCount();
+    recordScalar("likelihoodRatio:cycleMean", cycleLikelihoodRatios.getMean());
+    recordScalar("likelihoodRatio:cycleStddev", cycleLikelihoodRatios.getStddev());
+    recordScalar("likelihoodRatio:cycleMax", cycleLikelihoodRatios.getMax());
+    recordInterval("MRT", "weighted", mrt, weightedCycleTotals.deltaMethodVariance(mrtGradient), cycles);
+    recordInterval("renegingProbability", "weighted", reneging, weightedCycleTotals.deltaMethodVariance(renegingGradient), cycles);
 }
 
 void LimitedSink::finish()
 {
-    // TODO missing scalar statistics
+    profile.record();
+    if (jobPool)
+        recordScalar("jobPool:released", jobPool->getReleased());
+
+    // pipelines of a MultiDeadlineNetwork differ only by their deadline
+    if (getParentModule()->hasPar("deadline"))
+        recordScalar("deadline", getParentModule()->par("deadline").doubleValue(), "s");
+
+    if (autoWarmup) {
+        recordScalar("warmup:detected", truncationFound);
+        if (warmupDetected) {
+            recordScalar("warmup:truncationTime", truncationTime, "s");
+            recordScalar("warmup:truncationJobs", truncationJobs);
+            recordScalar("warmup:switchTime", warmupSwitchTime, "s");
+        }
+    }
+
+    if (!streamingStatistics)
+        return;
+
+    double mrt = OffloadingMetrics::meanResponseTime(responseTimeStats.getSum(), responseTimeStats.getCount());
+    double mec = OffloadingMetrics::meanEnergyConsumption(energyStats.getSum(), energyStats.getCount());
+
+    recordScalar("jobs", responseTimeStats.getCount());
+    recordScalar("responseTime:mean", responseTimeStats.getMean(), "s");
+    recordScalar("responseTime:stddev", responseTimeStats.getStddev(), "s");
+    recordScalar("responseTime:min", responseTimeStats.getMin(), "s");
+    recordScalar("responseTime:max", responseTimeStats.getMax(), "s");
+    responseTimeHistogram->record();
+
+    recordScalar("energy:sum", energyStats.getSum(), "J");
+    recordScalar("energy:count", energyStats.getCount());
+
+    recordScalar("MRT", mrt);
+    recordScalar("MEC", mec);
+    for (double w : erwpExponents)
+        recordScalar(OffloadingMetrics::erwpName(w).c_str(), OffloadingMetrics::erwp(mec, mrt, w));
+
+    if (numBatches > 0)
+        recordBatchMeans();
+    if (regenerative)
+        recordRegenerativeEstimates();
+    if (importanceSampling)
+        recordImportanceSamplingEstimates();
 }
 
 
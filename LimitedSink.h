@@ -8,15 +8,57 @@
 #ifndef LIMITEDSINK_H_
 #define LIMITEDSINK_H_
 
+#include <map>
+#include <string>
+#include <vector>
+
 #include "QueueingDefs.h"
 #include "Job.h"
+#include "OffloadingMetrics.h"
+#include "JobPool.h"
+#include "Snapshot.h"
+#include "EventProfile.h"
+
+class LimitedSource;
+class JobReplicator;
+class OffloadingQueue;
+class QueueCustom;
 
 using namespace queueing;
 
 /**
  * Consumes jobs; see NED file for more info.
+ *
+ * In streaming statistics mode it also listens to the jobServiceTime signal
+ * of the queues in the same network and records MRT, MEC and ERWP as run
+ * scalars, so vectors are not needed to compute the final metrics.
+ *
+ * With numBatches > 0 the measured jobs are split into batches of batchSize
+ * jobs (batch means), so a single long run yields the confidence intervals
+ * of MRT, MEC and ERWP. The energy is then read from the energyAttributes of
+ * the jobs when they depart, like the response time, so that a batch has
+ * whole jobs.
+ *
+ * With autoWarmup the end of the transient is detected online with the
+ * MSER-m rule on the response times of the warmup jobs; the source then
+ * starts creating measured jobs.
+ *
+ * In regenerative mode the run is split at the regeneration points of the
+ * model: WiFi turns on while all the queues of the network are empty. The
+ * source starts creating measured jobs at the first of them, and the totals
+ * of every cycle, which are i.i.d., give ratio estimators of MRT, MEC and
+ * ERWP with their confidence intervals (delta method) from a single run,
+ * with neither a warmup period nor replications. When the OffloadingQueue
+ * does importance sampling, every job is also weighted by the likelihood
+ * ratio of the draws of its cycle up to its departure, which gives unbiased
+ * cycle totals, hence estimates of MRT and of the reneging probability of
+ * the original system.
+ *
+ * With a completionModule the sink is one of several pipelines fed by a
+ * JobReplicator: instead of ending the simulation it reports that it is
+ * complete and ignores the jobs that still arrive.
  */
-class QUEUEING_API LimitedSink : public cSimpleModule
+class QUEUEING_API LimitedSink : public cSimpleModule, public cListener, public Checkpointable
 {
   private:
     simsignal_t lifeTimeSignal;
@@ -28,13 +70,116 @@ class QUEUEING_API LimitedSink : public cSimpleModule
     simsignal_t generationSignal;
     bool keepJobs;
     int jobCounter;
+    JobPool *jobPool;
 
     simsignal_t totalResponseTime;
+    simsignal_t jobServiceTimeSignal;
+    simsignal_t cellularServiceTimeSignal;
+
+    bool streamingStatistics;
+    std::vector<double> erwpExponents;
+    RunningStatistic responseTimeStats;
+    cPSquare *responseTimeHistogram;
+    RunningStatistic energyStats;
+    std::map<std::pair<int, simsignal_t>, double> powerCoefficients;
+    std::vector<std::string> energyAttributes;
+
+    struct BatchTotals {
+        double responseTimeSum;
+        long jobs;
+        double energySum;
+        long energyCount;
+    };
+
+    int numBatches;
+    long batchSize;
+    std::vector<BatchTotals> batches;
+    BatchTotals currentBatch;
+
+    LimitedSource *jobSource;
+    bool autoWarmup;
+    bool warmupDetected;
+    MserTruncation warmupDetector;
+    int warmupCheckInterval;
+    int nextWarmupCheck;
+    bool truncationFound;
+    long warmupMaxJobs;
+    simtime_t truncationTime;
+    long truncationJobs;
+    simtime_t warmupSwitchTime;
+
+    bool regenerative;
+    simsignal_t wifiStatusSignal;
+    std::vector<OffloadingQueue *> offloadingQueues;
+    std::vector<QueueCustom *> customQueues;
+    int regenerationCycles;
+    bool regenerationStarted;
+    simtime_t firstRegeneration;
+    simtime_t cycleStart;
+    BatchTotals currentCycle;
+    VectorStatistic cycleTotals;
+    RunningStatistic cycleLengths;
+
+    // importance sampling: the jobs of every cycle weighted by the likelihood
+    // ratio of the cycle up to their departure
+    struct WeightedTotals {
+        double responseTimeSum;
+        double jobs;
+        double reneged;
+    };
+    bool importanceSampling;
+    WeightedTotals currentWeightedCycle;
+    VectorStatistic weightedCycleTotals;
+    RunningStatistic cycleLikelihoodRatios;
+
+    enum EventType { ARRIVAL_EVENT = 0, SERVICE_TIME_SIGNAL, WIFI_STATUS_SIGNAL };
+    EventProfile profile;
+
+    // emits are timed by the profile
+    template <typename T> void emit(simsignal_t signal, T value) {
+        EventProfile::EmitScope scope(profile);
+        cSimpleModule::emit(signal, value);
+    }
+
+    JobReplicator *completionModule;
+    bool completed;
+    bool restored;
+
+    double getPowerCoefficient(cComponent *source, simsignal_t signalID);
+    void collectEnergy(double energy);
+
+    void checkWarmup(Job *job);
+    void endWarmup(int truncation);
+
+    void releaseJob(Job *job);
+    void complete();
+
+    void closeBatch();
+    double batchResponseAutocorrelation() const;
+    void mergeBatchPairs();
+    void recordBatchMeans();
+
+    bool isSystemEmpty() const;
+    void regeneration();
+    double likelihoodRatio() const;
+    void recordRegenerativeEstimates();
+    void recordImportanceSamplingEstimates();
+    void recordInterval(const std::string& name, const char *method, double estimate, double variance, long samples);
+
+  public:
+    LimitedSink();
+    virtual ~LimitedSink();
+
+    virtual void saveState(SnapshotWriter& out) override;
+    virtual void restoreState(SnapshotReader& in) override;
 
   protected:
     virtual void initialize() override;
     virtual void handleMessage(cMessage *msg) override;
     virtual void finish() override;
+
+    virtual void receiveSignal(cComponent *source, simsignal_t signalID, const SimTime& t, cObject *details) override;
+    virtual void receiveSignal(cComponent *source, simsignal_t signalID, bool b, cObject *details) override;
 };
 
 
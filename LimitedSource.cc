@@ -8,6 +8,9 @@
 #include "LimitedSource.h"
 #include "Job.h"
 
+#include <cmath>
+#include <new>
+
 
 Define_Module(LimitedSource);
 
@@ -19,39 +22,149 @@ void LimitedSource::initialize()
     warmupExceeded = false;
     transientAnalysis = par("transientAnalysis").boolValue();
     numJobs = transientAnalysis ? par("numJobs") : -1;
+    recycleJobs = par("recycleJobs");
+    interArrivalTime.initialize(this, "interArrivalTime");
+    profile.initialize(this, { "new_job" });
+
+    sizeAttribute = par("sizeAttribute").stdstringValue();
+    jobSize.initialize(this, "jobSize");
+    trace.initialize(this, "traceFile", "recordTrace");
+    replayedSize = NAN;
+
+    // schedule the first message timer for start time, or the first arrival of the trace
+    newJobTimer = new cMessage("newJobTimer");
+    if (trace.isReplaying())
+        scheduleReplayedArrival();
+    else
+        scheduleAt(startTime, newJobTimer);
+}
 
-    // schedule the first message timer for start time
-    scheduleAt(startTime, new cMessage("newJobTimer"));
+void LimitedSource::scheduleReplayedArrival()
+{
+    simtime_t arrivalTime;
+    if (trace.nextArrival(arrivalTime, replayedSize))
+        scheduleAt(arrivalTime, newJobTimer);
+    else {
+        EV << "End of the arrival trace" << endl;
+        delete newJobTimer;
+        newJobTimer = nullptr;
+    }
 }
 
 void LimitedSource::handleMessage(cMessage *msg)
 {
     ASSERT(msg->isSelfMessage());
+    EventProfile::Scope scope(profile, 0);
 
     simtime_t warmup = getSimulation()->getWarmupPeriod();
-    if (simTime() >= warmup && warmup > 0 && !warmupExceeded) {
-        numJobs = par("numJobs");
-        jobCounter = 0;
-        warmupExceeded = true;
-    }
+    if (simTime() >= warmup && warmup > 0 && !warmupExceeded)
+        endWarmup();
 
     if ((numJobs < 0 || numJobs > jobCounter) && (stopTime < 0 || stopTime > simTime())) {
         // reschedule the timer for the next message
-        scheduleAt(simTime() + par("interArrivalTime").doubleValue(), msg);
+        double size = replayedSize;
+        if (trace.isReplaying())
+            scheduleReplayedArrival();
+        else
+            scheduleAt(simTime() + interArrivalTime.draw(), msg);
 
-        Job *job = createJob();
+        Job *job = recycleJobs ? createRecycledJob() : createJob();
         if (warmupExceeded || transientAnalysis)
             job->setKind(1);
 
+        // the size is the service time of the queue with serviceTimeAttribute
+        if (!sizeAttribute.empty()) {
+            if (std::isnan(size))
+                size = jobSize.draw();
+            job->addPar(sizeAttribute.c_str()).setDoubleValue(size);
+        }
+        trace.recordArrival(simTime(), size);
+
         send(job, "out");
     }
     else {
         // finished
         delete msg;
+        newJobTimer = nullptr;
     }
 }
 
+void LimitedSource::endWarmup()
+{
+    Enter_Method("endWarmup()");
+    numJobs = par("numJobs");
+    jobCounter = 0;
+    warmupExceeded = true;
+}
 
+Job *LimitedSource::createRecycledJob()
+{
+    void *storage = jobPool.acquire();
+    if (!storage)
+        return createJob();
 
+    // same as SourceBase::createJob(), constructed in the recycled storage
+    char buf[80];
+    sprintf(buf, "%.60s-%d", jobName.c_str(), ++jobCounter);
+    Job *job = new (storage) Job(buf);
+    job->setKind(par("jobType").intValue());
+    job->setPriority(par("jobPriority").intValue());
+    return job;
+}
 
+void LimitedSource::finish()
+{
+    SourceBase::finish();
+    profile.record();
+    trace.finish();
 
+    if (recycleJobs) {
+        recordScalar("jobPool:hits", jobPool.getHits());
+        recordScalar("jobPool:misses", jobPool.getMisses());
+        recordScalar("jobPool:free", jobPool.getFreeCount());
+    }
+}
+
+void LimitedSource::saveState(SnapshotWriter& out)
+{
+    if (trace.isReplaying())
+        throw cRuntimeError("Snapshots of runs replaying a trace are not supported");
+    out.writeInt(jobCounter);
+    out.writeInt(numJobs);
+    out.writeBool(warmupExceeded);
+    out.writeTimer(newJobTimer);
+    interArrivalTime.saveState(out);
+    if (!sizeAttribute.empty())
+        jobSize.saveState(out);
+}
+
+void LimitedSource::restoreState(SnapshotReader& in)
+{
+    Enter_Method_Silent();
+    if (trace.isReplaying())
+        throw cRuntimeError("Snapshots of runs replaying a trace are not supported");
+    jobCounter = in.readInt();
+    numJobs = in.readInt();
+    warmupExceeded = in.readBool();
+
+    simtime_t arrivalTime;
+    if (newJobTimer)
+        cancelEvent(newJobTimer);
+    if (in.readTimer(arrivalTime)) {
+        if (!newJobTimer)
+            newJobTimer = new cMessage("newJobTimer");
+        scheduleAt(arrivalTime, newJobTimer);
+    }
+    else {
+        delete newJobTimer;
+        newJobTimer = nullptr;
+    }
+    interArrivalTime.restoreState(in);
+    if (!sizeAttribute.empty())
+        jobSize.restoreState(in);
+
+    // the snapshot was taken during the warmup: measure from the start of
+    // this run, unless it has a warmup period of its own
+    if (!warmupExceeded && getSimulation()->getWarmupPeriod() == SIMTIME_ZERO)
+        endWarmup();
+}
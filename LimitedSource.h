@@ -8,13 +8,20 @@
 #ifndef LIMITEDSOURCE_H_
 #define LIMITEDSOURCE_H_
 
+#include <string>
+
 #include "QueueingDefs.h"
 #include "Source.h"
+#include "JobPool.h"
+#include "Snapshot.h"
+#include "BatchedVariate.h"
+#include "EventProfile.h"
+#include "TraceStream.h"
 
 using namespace queueing;
 
 
-class QUEUEING_API LimitedSource : public SourceBase
+class QUEUEING_API LimitedSource : public SourceBase, public Checkpointable
 {
     private:
         simtime_t startTime;
@@ -23,9 +30,37 @@ class QUEUEING_API LimitedSource : public SourceBase
         bool warmupExceeded;
         bool transientAnalysis;
 
+        bool recycleJobs;
+        JobPool jobPool;
+        cMessage *newJobTimer;
+        BatchedVariate interArrivalTime;
+        EventProfile profile;
+
+        std::string sizeAttribute;
+        BatchedVariate jobSize;
+        TraceStream trace;
+        double replayedSize;    // of the arrival the timer is scheduled for, NaN if the trace has none
+
+        Job *createRecycledJob();
+        // schedules the timer at the next arrival of the trace, or deletes it at the end
+        void scheduleReplayedArrival();
+
+    public:
+        // storage of consumed jobs, filled by the sink when recycleJobs is set
+        JobPool *getJobPool() { return &jobPool; }
+
+        // starts creating measured jobs (kind 1); called at the warmup period
+        // or by the sink when it detects the end of the transient (autoWarmup)
+        void endWarmup();
+        bool isWarmupOver() const { return warmupExceeded; }
+
+        virtual void saveState(SnapshotWriter& out) override;
+        virtual void restoreState(SnapshotReader& in) override;
+
     protected:
         virtual void initialize() override;
         virtual void handleMessage(cMessage *msg) override;
+        virtual void finish() override;
 };
 
 
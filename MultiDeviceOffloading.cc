@@ -0,0 +1,415 @@
+/*
+ * MultiDeviceOffloading.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "MultiDeviceOffloading.h"
+
+#include <algorithm>
+
+Define_Module(MultiDeviceOffloading);
+
+MultiDeviceOffloading::MultiDeviceOffloading() {
+    calendarMsg = nullptr;
+}
+
+MultiDeviceOffloading::~MultiDeviceOffloading() {
+    cancelAndDelete(calendarMsg);
+}
+
+void MultiDeviceOffloading::initialize() {
+    numDevices = par("numDevices");
+    if (numDevices <= 0)
+        throw cRuntimeError("numDevices must be positive");
+
+    jobServiceTimeSignal = registerSignal("jobServiceTime");
+    cellularServiceTimeSignal = registerSignal("cellularServiceTime");
+
+    interArrivalTime.initialize(this, "interArrivalTime");
+    serviceTime.initialize(this, "serviceTime");
+    cellularServiceTime.initialize(this, "cellularServiceTime");
+    deadlineDistribution.initialize(this, "deadlineDistribution");
+    wifiStateDistribution.initialize(this, "wifiStateDistribution");
+    cellularStateDistribution.initialize(this, "cellularStateDistribution");
+    profile.initialize(this, { "arrival", "wifi_status_changed", "end_service", "deadline_reached", "cellular_end_service" });
+
+    wifiAvailable.assign(numDevices, 0);
+    nextStatusChangeTime.assign(numDevices, SIMTIME_ZERO);
+    curJobServiceTime.assign(numDevices, SIMTIME_ZERO);
+    servicedJob.assign(numDevices, NONE);
+    suspendedJob.assign(numDevices, NONE);
+    serviceGeneration.assign(numDevices, 0);
+    deadlineQueue.assign(numDevices, JobList{NONE, NONE});
+    waitingQueue.assign(numDevices, JobList{NONE, NONE});
+    cellularQueue.assign(numDevices, JobList{NONE, NONE});
+    cellularJob.assign(numDevices, NONE);
+
+    jobs.clear();
+    freeJobs = NONE;
+    createdJobs = 0;
+    activeJobs = peakJobs = 0;
+    WATCH(createdJobs);
+    WATCH(activeJobs);
+
+    // an arrival and a WiFi status change per device, plus the services and deadlines
+    calendar.clear();
+    calendar.reserve(4 * numDevices);
+    eventSequence = 0;
+    cancelledEvents = 0;
+    peakCalendarLength = 0;
+    calendarMsg = new cMessage("calendar");
+
+    // as in OffloadingQueue, every device starts with the WiFi OFF
+    for (uint32_t device = 0; device < (uint32_t)numDevices; device++) {
+        schedule(simTime() + interArrivalTime.draw(), ARRIVAL_EVENT, device);
+        updateNextStatusChangeTime(device);
+    }
+    scheduleCalendar();
+
+    EV << "Called INITIALIZE on MultiDeviceOffloading with " << numDevices << " devices\n";
+}
+
+void MultiDeviceOffloading::handleMessage(cMessage *msg) {
+    ASSERT(msg == calendarMsg);
+
+    // all the timers due now, in scheduling order; cancelled ones are skipped
+    while (!calendar.empty() && calendar.front().time == simTime()) {
+        Event event = calendar.front();
+        std::pop_heap(calendar.begin(), calendar.end(), EventAfter());
+        calendar.pop_back();
+        if (isCancelled(event)) {
+            cancelledEvents--;
+            continue;
+        }
+
+        switch (event.type) {
+            case ARRIVAL_EVENT: {
+                EventProfile::Scope scope(profile, ARRIVAL_EVENT);
+                arrival(event.target);
+                break;
+            }
+            case WIFI_STATUS_EVENT: {
+                EventProfile::Scope scope(profile, WIFI_STATUS_EVENT);
+                wifiStatusChange(event.target);
+                break;
+            }
+            case END_SERVICE_EVENT: {
+                EventProfile::Scope scope(profile, END_SERVICE_EVENT);
+                endService(event.target);
+                break;
+            }
+            case DEADLINE_EVENT: {
+                EventProfile::Scope scope(profile, DEADLINE_EVENT);
+                deadlineReached(event.target);
+                break;
+            }
+            case CELLULAR_END_SERVICE_EVENT: {
+                EventProfile::Scope scope(profile, CELLULAR_END_SERVICE_EVENT);
+                endCellularService(event.target);
+                break;
+            }
+        }
+    }
+    if (cancelledEvents > calendar.size() / 2)
+        purgeCalendar();
+    scheduleCalendar();
+}
+
+bool MultiDeviceOffloading::isCancelled(const Event& event) const {
+    if (event.type == END_SERVICE_EVENT)
+        return event.generation != serviceGeneration[event.target];
+    if (event.type == DEADLINE_EVENT)
+        return event.generation != jobs[event.target].generation;
+    return false;
+}
+
+void MultiDeviceOffloading::purgeCalendar() {
+    // the deadline of a job served in time stays in the calendar until it
+    // expires, hours later: drop the cancelled timers once they are the
+    // majority, so the calendar stays within twice the pending ones
+    calendar.erase(std::remove_if(calendar.begin(), calendar.end(), [this](const Event& event) { return isCancelled(event); }), calendar.end());
+    std::make_heap(calendar.begin(), calendar.end(), EventAfter());
+    cancelledEvents = 0;
+}
+
+void MultiDeviceOffloading::schedule(simtime_t time, EventType type, uint32_t target, uint32_t generation) {
+    calendar.push_back(Event{time, eventSequence++, target, generation, type});
+    std::push_heap(calendar.begin(), calendar.end(), EventAfter());
+    if (calendar.size() > peakCalendarLength)
+        peakCalendarLength = calendar.size();
+}
+
+void MultiDeviceOffloading::scheduleCalendar() {
+    if (calendar.empty())
+        return;
+
+    simtime_t earliest = calendar.front().time;
+    if (calendarMsg->isScheduled()) {
+        if (calendarMsg->getArrivalTime() == earliest)
+            return;
+        cancelEvent(calendarMsg);
+    }
+    scheduleAt(earliest, calendarMsg);
+}
+
+uint32_t MultiDeviceOffloading::allocateJob(uint32_t device) {
+    uint32_t job;
+    if (freeJobs != NONE) {
+        job = freeJobs;
+        freeJobs = jobs[job].next;
+    }
+    else {
+        job = jobs.size();
+        jobs.push_back(JobSlot());
+        jobs[job].generation = 0;
+    }
+
+    jobs[job].device = device;
+    jobs[job].next = NONE;
+    if (++activeJobs > peakJobs)
+        peakJobs = activeJobs;
+    return job;
+}
+
+void MultiDeviceOffloading::releaseJob(uint32_t job) {
+    // pending deadlines of the slot become stale
+    jobs[job].generation++;
+    jobs[job].next = freeJobs;
+    freeJobs = job;
+    activeJobs--;
+}
+
+void MultiDeviceOffloading::append(JobList& list, uint32_t job) {
+    jobs[job].next = NONE;
+    if (list.tail == NONE)
+        list.head = job;
+    else
+        jobs[list.tail].next = job;
+    list.tail = job;
+}
+
+void MultiDeviceOffloading::insertByDeadline(JobList& list, uint32_t job) {
+    // deadlines mostly come in order, equal ones are served by arrival
+    simtime_t deadline = jobs[job].deadline;
+    if (list.tail == NONE || jobs[list.tail].deadline <= deadline) {
+        append(list, job);
+        return;
+    }
+
+    uint32_t previous = NONE;
+    uint32_t current = list.head;
+    while (jobs[current].deadline <= deadline) {
+        previous = current;
+        current = jobs[current].next;
+    }
+    jobs[job].next = current;
+    if (previous == NONE)
+        list.head = job;
+    else
+        jobs[previous].next = job;
+}
+
+uint32_t MultiDeviceOffloading::popFront(JobList& list) {
+    uint32_t job = list.head;
+    list.head = jobs[job].next;
+    if (list.head == NONE)
+        list.tail = NONE;
+    return job;
+}
+
+void MultiDeviceOffloading::arrival(uint32_t device) {
+    schedule(simTime() + interArrivalTime.draw(), ARRIVAL_EVENT, device);
+
+    uint32_t job = allocateJob(device);
+    createdJobs++;
+    JobSlot& slot = jobs[job];
+    slot.timestamp = simTime();
+    slot.queueingTime = SIMTIME_ZERO;
+    slot.serviceTime = SIMTIME_ZERO;
+    slot.deadline = SimTime::getMaxTime();
+    slot.queueCount = 1;
+    slot.measured = simTime() >= getSimulation()->getWarmupPeriod();
+
+    // WIFI is OFF so add deadline to jobs
+    if (!wifiAvailable[device]) {
+        slot.deadline = simTime() + deadlineDistribution.draw();
+        schedule(slot.deadline, DEADLINE_EVENT, job, slot.generation);
+    }
+
+    if (wifiAvailable[device] && servicedJob[device] == NONE) {
+        servicedJob[device] = job;
+        startService(device);
+    }
+    else if (slot.deadline != SimTime::getMaxTime())
+        insertByDeadline(deadlineQueue[device], job);
+    else
+        append(waitingQueue[device], job);
+}
+
+void MultiDeviceOffloading::wifiStatusChange(uint32_t device) {
+    wifiAvailable[device] = !wifiAvailable[device];
+
+    // wifi OFF -> ON
+    if (wifiAvailable[device]) {
+        if (suspendedJob[device] != NONE) resumeService(device);
+        else prepareNextJobIfAny(device);
+        updateNextStatusChangeTime(device);
+    }
+    // wifi ON -> OFF
+    else {
+        updateNextStatusChangeTime(device);
+        if (servicedJob[device] != NONE)
+            suspendService(device);
+    }
+}
+
+void MultiDeviceOffloading::updateNextStatusChangeTime(uint32_t device) {
+    simtime_t nextChange = wifiAvailable[device] ? wifiStateDistribution.draw() : cellularStateDistribution.draw();
+    nextStatusChangeTime[device] = simTime() + nextChange;
+    schedule(nextStatusChangeTime[device], WIFI_STATUS_EVENT, device);
+}
+
+void MultiDeviceOffloading::startService(uint32_t device) {
+    JobSlot& slot = jobs[servicedJob[device]];
+    slot.queueingTime += simTime() - slot.timestamp;
+    slot.timestamp = simTime();
+    curJobServiceTime[device] = serviceTime.draw();
+    schedule(simTime() + curJobServiceTime[device], END_SERVICE_EVENT, device, serviceGeneration[device]);
+}
+
+void MultiDeviceOffloading::endService(uint32_t device) {
+    uint32_t job = servicedJob[device];
+    JobSlot& slot = jobs[job];
+    slot.serviceTime += simTime() - slot.timestamp;
+    if (slot.measured)
+        emit(jobServiceTimeSignal, slot.serviceTime);
+    // its deadline timer, cancelled when the slot is released
+    if (slot.deadline != SimTime::getMaxTime())
+        cancelledEvents++;
+
+    sendJob(job);
+    prepareNextJobIfAny(device);
+}
+
+void MultiDeviceOffloading::prepareNextJobIfAny(uint32_t device) {
+    // jobs with a deadline first, as in OffloadingQueue
+    uint32_t job = NONE;
+    if (deadlineQueue[device].head != NONE)
+        job = popFront(deadlineQueue[device]);
+    else if (waitingQueue[device].head != NONE)
+        job = popFront(waitingQueue[device]);
+
+    servicedJob[device] = job;
+    if (job != NONE)
+        startService(device);
+}
+
+void MultiDeviceOffloading::suspendService(uint32_t device) {
+    uint32_t job = servicedJob[device];
+    JobSlot& slot = jobs[job];
+    simtime_t elapsedTime = simTime() - slot.timestamp;
+    simtime_t remainingTime = curJobServiceTime[device] - elapsedTime;
+    serviceGeneration[device]++;
+    cancelledEvents++;
+    schedule(nextStatusChangeTime[device] + remainingTime, END_SERVICE_EVENT, device, serviceGeneration[device]);
+    slot.serviceTime += elapsedTime;
+
+    slot.timestamp = simTime();
+    suspendedJob[device] = job;
+    servicedJob[device] = NONE;
+}
+
+void MultiDeviceOffloading::resumeService(uint32_t device) {
+    uint32_t job = suspendedJob[device];
+    JobSlot& slot = jobs[job];
+    slot.queueingTime += simTime() - slot.timestamp;
+    slot.timestamp = simTime();
+    servicedJob[device] = job;
+    suspendedJob[device] = NONE;
+}
+
+void MultiDeviceOffloading::deadlineReached(uint32_t job) {
+    uint32_t device = jobs[job].device;
+
+    if (job == servicedJob[device]) {
+        serviceGeneration[device]++;
+        cancelledEvents++;
+        prepareNextJobIfAny(device);
+    }
+    else if (job == suspendedJob[device]) {
+        suspendedJob[device] = NONE;
+        serviceGeneration[device]++;
+        cancelledEvents++;
+    }
+    else {
+        // the earliest deadline of the device, so the head of its queue
+        ASSERT(deadlineQueue[device].head == job);
+        popFront(deadlineQueue[device]);
+    }
+
+    // the job has left the WiFi queue
+    jobs[job].generation++;
+    cellularArrival(job);
+}
+
+void MultiDeviceOffloading::cellularArrival(uint32_t job) {
+    uint32_t device = jobs[job].device;
+    jobs[job].queueCount++;
+    jobs[job].timestamp = simTime();
+
+    if (cellularJob[device] == NONE) {
+        cellularJob[device] = job;
+        startCellularService(device);
+    }
+    else
+        append(cellularQueue[device], job);
+}
+
+void MultiDeviceOffloading::startCellularService(uint32_t device) {
+    JobSlot& slot = jobs[cellularJob[device]];
+    slot.queueingTime += simTime() - slot.timestamp;
+    slot.timestamp = simTime();
+    schedule(simTime() + cellularServiceTime.draw(), CELLULAR_END_SERVICE_EVENT, device);
+}
+
+void MultiDeviceOffloading::endCellularService(uint32_t device) {
+    uint32_t job = cellularJob[device];
+    JobSlot& slot = jobs[job];
+    simtime_t delta = simTime() - slot.timestamp;
+    slot.serviceTime += delta;
+    if (slot.measured)
+        emit(cellularServiceTimeSignal, delta);
+
+    sendJob(job);
+    cellularJob[device] = cellularQueue[device].head != NONE ? popFront(cellularQueue[device]) : NONE;
+    if (cellularJob[device] != NONE)
+        startCellularService(device);
+}
+
+void MultiDeviceOffloading::sendJob(uint32_t job) {
+    const JobSlot& slot = jobs[job];
+    Job *message = new Job("job", slot.measured ? 1 : 0);
+    message->setQueueCount(slot.queueCount);
+    message->setTotalQueueingTime(slot.queueingTime);
+    message->setTotalServiceTime(slot.serviceTime);
+    releaseJob(job);
+    send(message, "out");
+}
+
+void MultiDeviceOffloading::finish() {
+    profile.record();
+
+    size_t bytes = wifiAvailable.capacity() * sizeof(uint8_t)
+            + (nextStatusChangeTime.capacity() + curJobServiceTime.capacity()) * sizeof(simtime_t)
+            + (servicedJob.capacity() + suspendedJob.capacity() + serviceGeneration.capacity() + cellularJob.capacity()) * sizeof(uint32_t)
+            + (deadlineQueue.capacity() + waitingQueue.capacity() + cellularQueue.capacity()) * sizeof(JobList)
+            + jobs.capacity() * sizeof(JobSlot) + calendar.capacity() * sizeof(Event);
+
+    recordScalar("devices", numDevices);
+    recordScalar("createdJobs", createdJobs);
+    recordScalar("peakJobs", peakJobs);
+    recordScalar("peakCalendarLength", peakCalendarLength);
+    recordScalar("bytesPerDevice", (double)bytes / numDevices, "B");
+}
@@ -0,0 +1,155 @@
+/*
+ * MultiDeviceOffloading.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef MULTIDEVICEOFFLOADING_H_
+#define MULTIDEVICEOFFLOADING_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "QueueingDefs.h"
+#include "Job.h"
+#include "BatchedVariate.h"
+#include "EventProfile.h"
+
+using namespace queueing;
+
+/**
+ * Many mobile devices in one module: each device has the arrivals, WiFi
+ * queue (with deadlines and suspended services, as OffloadingQueue), WiFi
+ * process and cellular queue (as QueueCustom) of a FullOffloadingNetwork,
+ * and the jobs leave through a single gate towards a shared remote stage.
+ *
+ * The state of the devices is kept in arrays indexed by device, the jobs
+ * waiting in a device in a pool of slots linked in per-device lists, and all
+ * the timers of all the devices in one internal calendar (a binary heap, on
+ * top of which a single message is scheduled), so a device costs a few
+ * hundred bytes and an event O(log devices). Cancelled timers are not
+ * removed from the calendar but skipped, by generation number, when they
+ * come up, or dropped all at once when they outnumber the pending ones.
+ * A Job message is only created when a job leaves the module.
+ * See NED file for more info.
+ */
+class QUEUEING_API MultiDeviceOffloading : public cSimpleModule
+{
+    private:
+        static const uint32_t NONE = UINT32_MAX;
+
+        enum EventType : uint8_t { ARRIVAL_EVENT = 0, WIFI_STATUS_EVENT, END_SERVICE_EVENT, DEADLINE_EVENT, CELLULAR_END_SERVICE_EVENT };
+
+        // timer of the calendar: target is a device, or a job slot for deadlines
+        struct Event {
+            simtime_t time;
+            uint64_t sequence;
+            uint32_t target;
+            uint32_t generation;
+            EventType type;
+        };
+
+        // puts the earliest event on top of the heap, in scheduling order among equal times
+        struct EventAfter {
+            bool operator()(const Event& a, const Event& b) const {
+                return a.time > b.time || (a.time == b.time && a.sequence > b.sequence);
+            }
+        };
+
+        struct JobSlot {
+            simtime_t timestamp;      // arrival in the current queue or start of service
+            simtime_t queueingTime;
+            simtime_t serviceTime;
+            simtime_t deadline;       // SimTime::getMaxTime() if the job has none
+            uint32_t device;
+            uint32_t next;            // next job in the same list, or free slot
+            uint32_t generation;      // changes when the job leaves the WiFi queue
+            uint8_t queueCount;
+            bool measured;
+        };
+
+        struct JobList {
+            uint32_t head;
+            uint32_t tail;
+        };
+
+        int numDevices;
+
+        // per-device state
+        std::vector<uint8_t> wifiAvailable;
+        std::vector<simtime_t> nextStatusChangeTime;
+        std::vector<simtime_t> curJobServiceTime;
+        std::vector<uint32_t> servicedJob;
+        std::vector<uint32_t> suspendedJob;
+        std::vector<uint32_t> serviceGeneration;  // changes when the end of the WiFi service is cancelled
+        std::vector<JobList> deadlineQueue;       // waiting jobs with a deadline, by deadline
+        std::vector<JobList> waitingQueue;        // waiting jobs without a deadline, by arrival
+        std::vector<JobList> cellularQueue;
+        std::vector<uint32_t> cellularJob;
+
+        std::vector<JobSlot> jobs;
+        uint32_t freeJobs;
+        long createdJobs;
+        size_t activeJobs;
+        size_t peakJobs;
+
+        std::vector<Event> calendar;
+        uint64_t eventSequence;
+        size_t cancelledEvents;
+        size_t peakCalendarLength;
+        cMessage *calendarMsg;
+
+        BatchedVariate interArrivalTime;
+        BatchedVariate serviceTime;
+        BatchedVariate cellularServiceTime;
+        BatchedVariate deadlineDistribution;
+        BatchedVariate wifiStateDistribution;
+        BatchedVariate cellularStateDistribution;
+
+        simsignal_t jobServiceTimeSignal;
+        simsignal_t cellularServiceTimeSignal;
+        EventProfile profile;
+
+        // emits are timed by the profile
+        template <typename T> void emit(simsignal_t signal, T value) {
+            EventProfile::EmitScope scope(profile);
+            cSimpleModule::emit(signal, value);
+        }
+
+        void schedule(simtime_t time, EventType type, uint32_t target, uint32_t generation = 0);
+        void scheduleCalendar();
+        bool isCancelled(const Event& event) const;
+        void purgeCalendar();
+
+        uint32_t allocateJob(uint32_t device);
+        void releaseJob(uint32_t job);
+        void append(JobList& list, uint32_t job);
+        void insertByDeadline(JobList& list, uint32_t job);
+        uint32_t popFront(JobList& list);
+
+        void arrival(uint32_t device);
+        void wifiStatusChange(uint32_t device);
+        void updateNextStatusChangeTime(uint32_t device);
+        void startService(uint32_t device);
+        void endService(uint32_t device);
+        void prepareNextJobIfAny(uint32_t device);
+        void suspendService(uint32_t device);
+        void resumeService(uint32_t device);
+        void deadlineReached(uint32_t job);
+        void cellularArrival(uint32_t job);
+        void startCellularService(uint32_t device);
+        void endCellularService(uint32_t device);
+        void sendJob(uint32_t job);
+
+    public:
+        MultiDeviceOffloading();
+        virtual ~MultiDeviceOffloading();
+
+    protected:
+        virtual void initialize() override;
+        virtual void handleMessage(cMessage *msg) override;
+        virtual void finish() override;
+};
+
+#endif /* MULTIDEVICEOFFLOADING_H_ */
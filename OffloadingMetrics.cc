@@ -0,0 +1,289 @@
+/*
+ * OffloadingMetrics.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "OffloadingMetrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+void RunningStatistic::clear()
+{
+    count = 0;
+    mean = 0.0;
+    m2 = 0.0;
+    sum = 0.0;
+    min = std::numeric_limits<double>::infinity();
+    max = -std::numeric_limits<double>::infinity();
+}
+
+void RunningStatistic::collect(double value)
+{
+    count++;
+    double delta = value - mean;
+    mean += delta / count;
+    m2 += delta * (value - mean);
+    sum += value;
+    if (value < min) min = value;
+    if (value > max) max = value;
+}
+
+void RunningStatistic::merge(const RunningStatistic& other)
+{
+    if (other.count == 0)
+        return;
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+
+    long total = count + other.count;
+    double delta = other.mean - mean;
+    mean += delta * other.count / total;
+    m2 += other.m2 + delta * delta * count * other.count / total;
+    count = total;
+    sum += other.sum;
+    if (other.min < min) min = other.min;
+    if (other.max > max) max = other.max;
+}
+
+double RunningStatistic::getStddev() const
+{
+    return std::sqrt(getVariance());
+}
+
+void VectorStatistic::setDimension(int dimension)
+{
+    count = 0;
+    means.assign(dimension, 0.0);
+    comoments.assign(dimension * dimension, 0.0);
+}
+
+void VectorStatistic::collect(const std::vector<double>& values)
+{
+    // Welford update, the co-moments use the deviations before and after
+    int dimension = means.size();
+    std::vector<double> deltas(dimension);
+    count++;
+    for (int i = 0; i < dimension; i++) {
+        deltas[i] = values[i] - means[i];
+        means[i] += deltas[i] / count;
+    }
+    for (int i = 0; i < dimension; i++)
+        for (int j = 0; j < dimension; j++)
+            comoments[i * dimension + j] += deltas[i] * (values[j] - means[j]);
+}
+
+double VectorStatistic::getCovariance(int i, int j) const
+{
+    return count > 1 ? comoments[i * means.size() + j] / (count - 1) : 0.0;
+}
+
+double VectorStatistic::deltaMethodVariance(const std::vector<double>& gradient) const
+{
+    if (count < 2)
+        return std::numeric_limits<double>::infinity();
+    double variance = 0.0;
+    for (size_t i = 0; i < means.size(); i++)
+        for (size_t j = 0; j < means.size(); j++)
+            variance += gradient[i] * getCovariance(i, j) * gradient[j];
+    return variance / count;
+}
+
+void MserTruncation::setBatchSize(int size)
+{
+    batchSize = size;
+    batchMeans.clear();
+    batchEndTimes.clear();
+    currentSum = 0.0;
+    currentCount = 0;
+}
+
+void MserTruncation::collect(double value, double time)
+{
+    currentSum += value;
+    if (++currentCount < batchSize)
+        return;
+
+    batchMeans.push_back(currentSum / batchSize);
+    batchEndTimes.push_back(time);
+    currentSum = 0.0;
+    currentCount = 0;
+}
+
+int MserTruncation::computeTruncation() const
+{
+    int n = batchMeans.size();
+    if (n < 2)
+        return -1;
+
+    // suffix sums, so every candidate d costs O(1)
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    int best = -1;
+    double bestMser = std::numeric_limits<double>::infinity();
+    for (int d = n - 1; d >= 0; d--) {
+        sum += batchMeans[d];
+        sumSquares += batchMeans[d] * batchMeans[d];
+        if (d > n / 2)
+            continue;
+        double kept = n - d;
+        double mser = (sumSquares - sum * sum / kept) / (kept * kept);
+        if (mser <= bestMser) {
+            bestMser = mser;
+            best = d;
+        }
+    }
+    // a minimum on the boundary means the transient may not be over yet
+    return best < n / 2 ? best : -1;
+}
+
+double OffloadingMetrics::meanResponseTime(double responseTimeSum, long jobs)
+{
+    if (jobs == 0)
+        return std::numeric_limits<double>::quiet_NaN();
+    return responseTimeSum / jobs / SECONDS_PER_MINUTE;
+}
+
+double OffloadingMetrics::meanEnergyConsumption(double energySum, long jobs)
+{
+    if (jobs == 0)
+        return std::numeric_limits<double>::quiet_NaN();
+    return energySum / jobs / SECONDS_PER_MINUTE;
+}
+
+double OffloadingMetrics::erwp(double mec, double mrt, double w)
+{
+    return std::pow(mec, w) * std::pow(mrt, 1.0 - w);
+}
+
+std::string OffloadingMetrics::erwpName(double w)
+{
+    std::ostringstream name;
+    name << "ERWP_w_" << w;
+    return name.str();
+}
+
+double OffloadingMetrics::normalQuantile(double p)
+{
+    // Acklam's rational approximation, relative error below 1.2e-9
+    static const double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+    static const double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01 };
+    static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+    static const double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00, 3.754408661907416e+00 };
+    const double low = 0.02425;
+
+    if (p <= 0.0)
+        return -std::numeric_limits<double>::infinity();
+    if (p >= 1.0)
+        return std::numeric_limits<double>::infinity();
+
+    if (p < low || p > 1.0 - low) {
+        double q = std::sqrt(-2.0 * std::log(p < low ? p : 1.0 - p));
+        double x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+        return p < low ? x : -x;
+    }
+
+    double q = p - 0.5;
+    double r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+}
+
+namespace
+{
+    // continued fraction of the regularized incomplete beta function (Lentz)
+    double incompleteBetaFraction(double a, double b, double x)
+    {
+        const double tiny = 1e-300;
+        double c = 1.0;
+        double d = 1.0 - (a + b) * x / (a + 1.0);
+        d = 1.0 / (std::fabs(d) < tiny ? tiny : d);
+        double h = d;
+        for (int m = 1; m <= 300; m++) {
+            double m2 = 2.0 * m;
+            double even = m * (b - m) * x / ((a + m2 - 1.0) * (a + m2));
+            d = 1.0 + even * d;
+            d = 1.0 / (std::fabs(d) < tiny ? tiny : d);
+            c = 1.0 + even / c;
+            c = std::fabs(c) < tiny ? tiny : c;
+            h *= d * c;
+            double odd = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1.0));
+            d = 1.0 + odd * d;
+            d = 1.0 / (std::fabs(d) < tiny ? tiny : d);
+            c = 1.0 + odd / c;
+            c = std::fabs(c) < tiny ? tiny : c;
+            double delta = d * c;
+            h *= delta;
+            if (std::fabs(delta - 1.0) < 1e-15)
+                break;
+        }
+        return h;
+    }
+
+    double regularizedIncompleteBeta(double a, double b, double x)
+    {
+        if (x <= 0.0)
+            return 0.0;
+        if (x >= 1.0)
+            return 1.0;
+        double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) + b * std::log1p(-x));
+        if (x < (a + 1.0) / (a + b + 2.0))
+            return front * incompleteBetaFraction(a, b, x) / a;
+        return 1.0 - front * incompleteBetaFraction(b, a, 1.0 - x) / b;
+    }
+}
+
+double OffloadingMetrics::studentTDistribution(double t, long df)
+{
+    double n = df;
+    double tail = 0.5 * regularizedIncompleteBeta(n / 2.0, 0.5, n / (n + t * t));
+    return t > 0 ? 1.0 - tail : tail;
+}
+
+double OffloadingMetrics::studentTQuantile(double p, long df)
+{
+    if (df < 1)
+        return std::numeric_limits<double>::quiet_NaN();
+    if (p <= 0.0)
+        return -std::numeric_limits<double>::infinity();
+    if (p >= 1.0)
+        return std::numeric_limits<double>::infinity();
+    if (df == 1)
+        return std::tan(M_PI * (p - 0.5));
+    if (df == 2)
+        return (2.0 * p - 1.0) / std::sqrt(2.0 * p * (1.0 - p));
+
+    // Cornish-Fisher expansion around the normal quantile, a few 1e-2 off at
+    // df = 3, then Newton steps on the exact distribution function
+    double z = normalQuantile(p);
+    double n = df;
+    double z2 = z * z;
+    double g1 = (z2 + 1.0) * z / 4.0;
+    double g2 = ((5.0 * z2 + 16.0) * z2 + 3.0) * z / 96.0;
+    double g3 = (((3.0 * z2 + 19.0) * z2 + 17.0) * z2 - 15.0) * z / 384.0;
+    double g4 = ((((79.0 * z2 + 776.0) * z2 + 1482.0) * z2 - 1920.0) * z2 - 945.0) * z / 92160.0;
+    double t = z + g1 / n + g2 / (n * n) + g3 / (n * n * n) + g4 / (n * n * n * n);
+
+    double logNorm = std::lgamma((n + 1.0) / 2.0) - std::lgamma(n / 2.0) - 0.5 * std::log(n * M_PI);
+    for (int i = 0; i < 20; i++) {
+        double density = std::exp(logNorm - (n + 1.0) / 2.0 * std::log1p(t * t / n));
+        double step = (studentTDistribution(t, df) - p) / density;
+        t -= step;
+        if (std::fabs(step) <= 1e-12 * std::max(1.0, std::fabs(t)))
+            break;
+    }
+    return t;
+}
+
+double OffloadingMetrics::confidenceHalfWidth(const RunningStatistic& samples, double confidence)
+{
+    if (samples.getCount() < 2)
+        return std::numeric_limits<double>::infinity();
+    double t = studentTQuantile(0.5 + confidence / 2.0, samples.getCount() - 1);
+    return t * samples.getStddev() / std::sqrt((double)samples.getCount());
+}
@@ -0,0 +1,135 @@
+/*
+ * OffloadingMetrics.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef OFFLOADINGMETRICS_H_
+#define OFFLOADINGMETRICS_H_
+
+#include <string>
+#include <vector>
+
+/**
+ * Welford running mean/variance, so per-run statistics can be kept without
+ * storing every sample.
+ */
+class RunningStatistic
+{
+    private:
+        long count;
+        double mean;
+        double m2;
+        double sum;
+        double min;
+        double max;
+
+    public:
+        RunningStatistic() { clear(); }
+
+        void clear();
+        void collect(double value);
+        void merge(const RunningStatistic& other);
+
+        long getCount() const { return count; }
+        double getSum() const { return sum; }
+        double getMean() const { return mean; }
+        double getVariance() const { return count > 1 ? m2 / (count - 1) : 0.0; }
+        double getStddev() const;
+        double getMin() const { return min; }
+        double getMax() const { return max; }
+};
+
+/**
+ * Running means and covariance matrix of vectors of observations, e.g. the
+ * totals of the regeneration cycles, for the delta-method variance of a
+ * smooth function of the means.
+ */
+class VectorStatistic
+{
+    private:
+        long count;
+        std::vector<double> means;
+        std::vector<double> comoments;  // dimension x dimension, row major
+
+    public:
+        explicit VectorStatistic(int dimension = 0) { setDimension(dimension); }
+
+        void setDimension(int dimension);
+        void collect(const std::vector<double>& values);
+
+        int getDimension() const { return means.size(); }
+        long getCount() const { return count; }
+        double getMean(int i) const { return means[i]; }
+        double getCovariance(int i, int j) const;
+
+        // variance of g(means), gradient' * covariance * gradient / count,
+        // with the gradient of g at the means
+        double deltaMethodVariance(const std::vector<double>& gradient) const;
+};
+
+/**
+ * MSER-m truncation rule: observations are averaged in batches of m and the
+ * warmup ends at the batch d that minimizes the variance of the mean of the
+ * remaining batches, sum((y_i - mean_d)^2) / (n - d)^2, with d up to n/2. A
+ * minimum at n/2 is not trusted: more observations are needed.
+ */
+class MserTruncation
+{
+    private:
+        int batchSize;
+        std::vector<double> batchMeans;
+        std::vector<double> batchEndTimes;
+        double currentSum;
+        int currentCount;
+
+    public:
+        explicit MserTruncation(int batchSize = 5) { setBatchSize(batchSize); }
+
+        void setBatchSize(int size);
+        void collect(double value, double time);
+
+        int getBatchCount() const { return batchMeans.size(); }
+        long getObservationCount() const { return (long)batchMeans.size() * batchSize + currentCount; }
+
+        // number of batches to drop, or -1 if the rule has no valid answer yet
+        int computeTruncation() const;
+        double getBatchEndTime(int batch) const { return batchEndTimes[batch]; }
+};
+
+/**
+ * MRT, MEC and ERWP of a run, with the same definitions and units (minutes)
+ * used by analysis/analysis.py.
+ */
+namespace OffloadingMetrics
+{
+    const double SECONDS_PER_MINUTE = 60.0;
+
+    // mean response time; responseTimeSum in seconds
+    double meanResponseTime(double responseTimeSum, long jobs);
+
+    // mean energy consumption; energySum is sum(powerCoefficient * serviceTime)
+    double meanEnergyConsumption(double energySum, long jobs);
+
+    // energy-response weighted product with exponent w
+    double erwp(double mec, double mrt, double w);
+
+    // scalar name used for ERWP results, e.g. "ERWP_w_0.5"
+    std::string erwpName(double w);
+
+    // p-quantile of the standard normal distribution
+    double normalQuantile(double p);
+
+    // distribution function of Student's t with df degrees of freedom
+    double studentTDistribution(double t, long df);
+
+    // p-quantile of Student's t distribution with df degrees of freedom,
+    // within 1e-9 (relative) of the exact value
+    double studentTQuantile(double p, long df);
+
+    // half width of the two-sided t confidence interval of the mean
+    double confidenceHalfWidth(const RunningStatistic& samples, double confidence);
+}
+
+#endif /* OFFLOADINGMETRICS_H_ */
@@ -6,58 +6,87 @@
  */
 
 #include "OffloadingQueue.h"
+#include "ConnectivityProcess.h"
 
 #include "Job.h"
 
+#include <cmath>
+
 Define_Module(OffloadingQueue);
 
-int OffloadingQueue::compareFunction(cObject *a, cObject *b) {
-    Job *jobA = check_and_cast<Job *>(a);
-    Job *jobB = check_and_cast<Job *>(b);
-    cMessage *aDeadline = (cMessage *)jobA->getContextPointer();
-    cMessage *bDeadline = (cMessage *)jobB->getContextPointer();
-    if (aDeadline && bDeadline) {
-        simtime_t now = simTime();
-        simtime_t timeLeftA = aDeadline->getArrivalTime() - now;
-        simtime_t timeLeftB = bDeadline->getArrivalTime() - now;
-        if (timeLeftA < timeLeftB) return -1;
-        else if (timeLeftA > timeLeftB) return 1;
-        else return 0;
-    }
-    else if (aDeadline || bDeadline) {
-        if (aDeadline) return -1;
-        else return 1;
-    }
-    else {
-        simtime_t creationTimeA = jobA->getCreationTime();
-        simtime_t creationTimeB = jobB->getCreationTime();
-        if (creationTimeA < creationTimeB) return -1;
-        else if (creationTimeA > creationTimeB) return 1;
-        else return 0;
-    }
+bool OffloadingQueue::QueueKeyCompare::operator()(const QueueKey& a, const QueueKey& b) const {
+    const QueueKey& first = lifo ? b : a;
+    const QueueKey& second = lifo ? a : b;
+    if (first.hasDeadline != second.hasDeadline)
+        return first.hasDeadline;
+    if (first.time != second.time)
+        return first.time < second.time;
+    return first.sequence < second.sequence;
 }
 
 void OffloadingQueue::updateNextStatusChangeTime() {
-    simtime_t nextChange = (wifiAvailable) ? par("wifiStateDistribution").doubleValue() : par("cellularStateDistribution").doubleValue();
+    simtime_t nextChange;
+    if (trace.isReplaying()) {
+        simtime_t changeTime;
+        if (!trace.nextWifiChange(!wifiAvailable, changeTime)) {
+            // the last period lasts forever: a suspended service is never resumed
+            nextStatusChangeTime = SimTime::getMaxTime();
+            EV << "End of the connectivity trace, WIFI stays " << (wifiAvailable ? "ON" : "OFF") << endl;
+            return;
+        }
+        nextChange = changeTime - simTime();
+    }
+    else
+        nextChange = (wifiAvailable) ? wifiStateVariate.draw() : drawCellularPeriod();
     if (wifiAvailable) emit(wifiActiveTime, nextChange);
     else emit(cellActiveTime, nextChange);
     nextStatusChangeTime = simTime() + nextChange;
     scheduleAt(nextStatusChangeTime, wifiStatusMsg);
-    EV << "Next WIFI status change time: " << nextStatusChangeTime << endl;
+    EV_DEBUG << "Next WIFI status change time: " << nextStatusChangeTime << endl;
+}
+
+simtime_t OffloadingQueue::drawCellularPeriod() {
+    if (!importanceSampling)
+        return cellularStateVariate.draw();
+
+    // only the periods in which a job waits are tilted, the others keep the
+    // original distribution and leave the likelihood ratio as it is
+    cellularPeriodTilted = !isEmpty();
+    if (!cellularPeriodTilted)
+        return cellularStateVariate.drawUntilted();
+    double period = cellularStateVariate.draw();
+    logLikelihoodRatio += std::log(cellularStateVariate.likelihoodRatio(period));
+    return period;
+}
+
+void OffloadingQueue::tiltCellularPeriod() {
+    // a job starts waiting in an untilted period: the period is exponential,
+    // so what is left of it can be drawn again, from the tilted distribution
+    double remaining = cellularStateVariate.draw();
+    logLikelihoodRatio += std::log(cellularStateVariate.likelihoodRatio(remaining));
+    cellularPeriodTilted = true;
+    nextStatusChangeTime = simTime() + remaining;
+    cancelEvent(wifiStatusMsg);
+    scheduleAt(nextStatusChangeTime, wifiStatusMsg);
+    EV_DEBUG << "Tilted the rest of the cellular period, next WIFI status change time: " << nextStatusChangeTime << endl;
 }
 
 OffloadingQueue::OffloadingQueue() {
     servicedJob = nullptr;
     endServiceMsg = nullptr;
     wifiStatusMsg = nullptr;
+    deadlineMsg = nullptr;
     suspendedJob = nullptr;
 }
 
 OffloadingQueue::~OffloadingQueue() {
     delete servicedJob;
     delete suspendedJob;
+    while (!queue.isEmpty())
+        delete queue.pop();
     cancelAndDelete(endServiceMsg);
     cancelAndDelete(wifiStatusMsg);
+    cancelAndDelete(deadlineMsg);
 }
 
 void OffloadingQueue::initialize() {
@@ -73,96 +102,169 @@ void OffloadingQueue::initialize() {
     cellActiveTime = registerSignal("cellActiveTime");
     deadlineDistrib = registerSignal("deadlineDistrib");
     jobServiceTimeSignal = registerSignal("jobServiceTime");
+    wifiStatusSignal = registerSignal("wifiStatus");
+
+    streamingStatistics = par("streamingStatistics");
+    powerCoefficient = par("powerCoefficient");
+    serviceTimeStats.clear();
+    serviceTimeAttribute = par("serviceTimeAttribute").stdstringValue();
+    energyAttribute = par("energyAttribute").stdstringValue();
+
+    serviceTimeVariate.initialize(this, "serviceTime");
+    deadlineVariate.initialize(this, "deadlineDistribution");
+    wifiStateVariate.initialize(this, "wifiStateDistribution");
+    cellularStateVariate.initialize(this, "cellularStateDistribution");
+    profile.initialize(this, { "arrival", "end_service", "deadline_reached", "wifi_status_changed" });
+    trace.initialize(this, "traceFile", "recordTrace");
+    jobsAfterTraceEnd = 0;
+    if (!par("connectivityModule").stdstringValue().empty() && (trace.isReplaying() || trace.isRecording()))
+        throw cRuntimeError("The WiFi periods come from the connectivityModule: set the traceFile or recordTrace of that module instead");
+
+    importanceSampling = par("importanceSampling");
+    cellularPeriodTilted = false;
+    resetLikelihoodRatio();
+    if (importanceSampling) {
+        if (trace.isReplaying())
+            throw cRuntimeError("importanceSampling cannot be used with a replayed trace");
+        // the periods drawn by a ConnectivityProcess are not tilted
+        if (!par("connectivityModule").stdstringValue().empty())
+            throw cRuntimeError("importanceSampling cannot be used with a connectivityModule");
+        cellularStateVariate.setTilt(par("cellularStateTilt"));
+        deadlineVariate.setTilt(par("deadlineTilt"));
+        EV << "Importance sampling: cellularStateDistribution " << cellularStateVariate.str() << ", deadlineDistribution " << deadlineVariate.str() << endl;
+    }
+    EV << "serviceTime: " << serviceTimeVariate.str() << ", deadlineDistribution: " << deadlineVariate.str() << endl;
 
     endServiceMsg = new cMessage("end_service");
     fifo = par("fifo");
     capacity = par("capacity");
-    queue.setName("queue");
-    queue.setup(compareFunction);
+    queue.setCompare(QueueKeyCompare(!fifo));
+    queueSequence = 0;
+
+    deadlineMsg = new cMessage("deadline_reached");
+    deadlineSequence = 0;
 
     wifiAvailable = false;
     wifiStatusMsg = new cMessage("wifi_status_changed");
-    updateNextStatusChangeTime();
+    if (!par("connectivityModule").stdstringValue().empty())
+        check_and_cast<ConnectivityProcess *>(getModuleByPath(par("connectivityModule")))->subscribe(this);
+    else
+        updateNextStatusChangeTime();
 
     EV << "Called INITIALIZE on QueueSubclass\nInitial wifiAvailable = " << (wifiAvailable ? "ON" : "OFF") << "\n";
 }
 
 void OffloadingQueue::handleMessage(cMessage *msg) {
-    std::string jobName = msg->getName();
-    if (jobName.std::string::compare("deadline_reached") == 0) {
-        if (msg->getContextPointer()) {
-            Job *job = (Job *)msg->getContextPointer();
-            msg->setContextPointer(nullptr);
-            EV << "DEADLINE REACHED! WIFI status: " << wifiAvailable << " - Associated job: " << job << endl;
-
-            if (hasGUI()) {
-                std::string text = std::string("Deadline for ") + std::string(job->getName());
-                bubble(text.c_str());
-            }
-
-            if (job == servicedJob) {
-                if (endServiceMsg->isScheduled())
-                    cancelEvent(endServiceMsg);
-
-                prepareNextJobIfAny();
-            }
-            else if (job == suspendedJob) {
-                suspendedJob = nullptr;
-                if (endServiceMsg->isScheduled())
-                    cancelEvent(endServiceMsg);
-            }
-            else
-                queue.remove(job);
-
-            emit(queueLengthSignal, length());
-            send(job, "out", 0);
-            delete msg;
-        }
-        else
-            EV << "DEADLINE REACHED!" << endl;
-    }
-    else if (msg == wifiStatusMsg) {
-        wifiAvailable = !wifiAvailable;
-        EV << "WIFI STATUS CHANGED! Now is " << (wifiAvailable ? "ON" : "OFF") << "\n";
-
-        // wifi OFF -> ON
-        if (wifiAvailable) {
-            if (suspendedJob) resumeService(suspendedJob);
-            else prepareNextJobIfAny();
-            updateNextStatusChangeTime();
-        }
-        // wifi ON -> OFF
-        else {
-            updateNextStatusChangeTime();
-            if (servicedJob)
-                suspendService(servicedJob);
-        }
+    // jobs are the most frequent messages; the timers are told apart by identity
+    if (!msg->isSelfMessage()) {
+        EventProfile::Scope scope(profile, ARRIVAL_EVENT);
+        handleJobArrival(check_and_cast<Job *>(msg));
     }
     else if (msg == endServiceMsg) {
+        EventProfile::Scope scope(profile, END_SERVICE_EVENT);
         endService(servicedJob, 1);
         prepareNextJobIfAny();
     }
+    else if (msg == deadlineMsg) {
+        EventProfile::Scope scope(profile, DEADLINE_EVENT);
+        handleDeadline();
+    }
+    else if (msg == wifiStatusMsg) {
+        EventProfile::Scope scope(profile, WIFI_STATUS_EVENT);
+        handleWifiStatusChange();
+    }
+    else
+        throw cRuntimeError("Unexpected self-message %s", msg->getName());
+}
+
+void OffloadingQueue::handleJobArrival(Job *job) {
+    arrival(job);
+
+    if (wifiAvailable && !servicedJob) {
+        servicedJob = job;
+        emit(busySignal, true);
+        scheduleEndService();
+    }
     else {
-        Job *job = check_and_cast<Job *>(msg);
-        arrival(job);
-
-        if (wifiAvailable && !servicedJob) {
-            servicedJob = job;
-            emit(busySignal, true);
-            simtime_t serviceTime = startService(servicedJob);
-            simtime_t nextSchedule = simTime() + serviceTime;
-            curJobServiceTime = serviceTime;
-            scheduleAt(nextSchedule, endServiceMsg);
-            EV << "Job service time: " << curJobServiceTime << endl;
-            EV << "END time for " << servicedJob << ": " << nextSchedule << endl;
-        }
-        else {
-            queue.insert(job);
-            emit(queueLengthSignal, length());
-        }
+        insertIntoQueue(job);
+        emit(queueLengthSignal, length());
     }
 }
 
+void OffloadingQueue::handleDeadline() {
+    // the timer always refers to the earliest deadline
+    Job *job = deadlines.pop();
+    EV_DEBUG << "DEADLINE REACHED! WIFI status: " << wifiAvailable << " - Associated job: " << job << endl;
+
+    if (hasGUI()) {
+        std::string text = std::string("Deadline for ") + std::string(job->getName());
+        bubble(text.c_str());
+    }
+
+    if (job == servicedJob) {
+        if (endServiceMsg->isScheduled())
+            cancelEvent(endServiceMsg);
+
+        prepareNextJobIfAny();
+    }
+    else if (job == suspendedJob) {
+        suspendedJob = nullptr;
+        if (endServiceMsg->isScheduled())
+            cancelEvent(endServiceMsg);
+    }
+    else
+        queue.remove(job);
+
+    emit(queueLengthSignal, length());
+    if (job->getKind() == 1 && isWifiFrozen())
+        jobsAfterTraceEnd++;
+    if (importanceSampling)
+        job->addPar("reneged").setBoolValue(true);
+    send(job, "out", 0);
+    rescheduleDeadlineTimer();
+}
+
+void OffloadingQueue::handleWifiStatusChange() {
+    wifiAvailable = !wifiAvailable;
+    trace.recordWifiChange(wifiAvailable, simTime());
+    EV_DEBUG << "WIFI STATUS CHANGED! Now is " << (wifiAvailable ? "ON" : "OFF") << "\n";
+
+    // wifi OFF -> ON
+    if (wifiAvailable) {
+        if (suspendedJob) resumeService(suspendedJob);
+        else prepareNextJobIfAny();
+        updateNextStatusChangeTime();
+    }
+    // wifi ON -> OFF
+    else {
+        updateNextStatusChangeTime();
+        if (servicedJob)
+            suspendService(servicedJob);
+    }
+    emit(wifiStatusSignal, wifiAvailable);
+}
+
+void OffloadingQueue::changeWifiStatus(bool available, simtime_t nextChange) {
+    Enter_Method_Silent();
+    // not a message of ours, but the same event as one
+    EventProfile::Scope scope(profile, WIFI_STATUS_EVENT);
+    if (available == wifiAvailable)
+        return;
+
+    // same as a wifi_status_changed message, with the period drawn by the process
+    wifiAvailable = available;
+    nextStatusChangeTime = nextChange;
+    EV_DEBUG << "WIFI STATUS CHANGED! Now is " << (wifiAvailable ? "ON" : "OFF") << "\n";
+
+    if (wifiAvailable) {
+        if (suspendedJob) resumeService(suspendedJob);
+        else prepareNextJobIfAny();
+    }
+    else if (servicedJob)
+        suspendService(servicedJob);
+    emit(wifiStatusSignal, wifiAvailable);
+}
+
 void OffloadingQueue::refreshDisplay() const {
     getDisplayString().setTagArg("i2", 0, servicedJob ? "status/execute" : "");
     getDisplayString().setTagArg("i", 1, wifiAvailable ? "lime" : "red");
@@ -176,27 +278,49 @@ void OffloadingQueue::prepareNextJobIfAny() {
     else {
         servicedJob = getFromQueue();
         emit(queueLengthSignal, length());
-        simtime_t serviceTime = startService(servicedJob);
-        simtime_t nextSchedule = simTime() + serviceTime;
-        curJobServiceTime = serviceTime;
-        scheduleAt(nextSchedule, endServiceMsg);
-        EV << "Job service time: " << curJobServiceTime << endl;
-        EV << "END time for " << servicedJob << ": " << nextSchedule << endl;
+        scheduleEndService();
     }
 }
 
+void OffloadingQueue::scheduleEndService() {
+    curJobServiceTime = startService(servicedJob);
+    simtime_t nextSchedule = simTime() + curJobServiceTime;
+    scheduleAt(nextSchedule, endServiceMsg);
+    EV_DEBUG << "Job service time: " << curJobServiceTime << endl;
+    EV_DEBUG << "END time for " << servicedJob << ": " << nextSchedule << endl;
+}
+
 Job* OffloadingQueue::getFromQueue() {
-    Job *job;
-    if (fifo)
-        job = (Job *)queue.pop();
-    else {
-        job = (Job *)queue.back();
-        queue.remove(job);
-    }
-    EV << "Getting job from queue: " << job << endl;
+    // the heap comparator already accounts for FIFO/LIFO
+    Job *job = queue.pop();
+    EV_DEBUG << "Getting job from queue: " << job << endl;
     return job;
 }
 
+void OffloadingQueue::insertIntoQueue(Job *job) {
+    QueueKey key;
+    key.hasDeadline = deadlines.contains(job);
+    key.time = key.hasDeadline ? deadlines.getKey(job).time : job->getCreationTime();
+    key.sequence = queueSequence++;
+    queue.insert(job, key);
+    profile.collectQueueLength(queue.getLength());
+}
+
+void OffloadingQueue::rescheduleDeadlineTimer() {
+    if (deadlines.isEmpty()) {
+        cancelEvent(deadlineMsg);
+        return;
+    }
+
+    simtime_t earliest = deadlines.frontKey().time;
+    if (deadlineMsg->isScheduled()) {
+        if (deadlineMsg->getArrivalTime() == earliest)
+            return;
+        cancelEvent(deadlineMsg);
+    }
+    scheduleAt(earliest, deadlineMsg);
+}
+
 int OffloadingQueue::length() {
     return queue.getLength();
 }
@@ -204,49 +328,63 @@ int OffloadingQueue::length() {
 void OffloadingQueue::arrival(Job *job) {
     job->setTimestamp();
     job->setQueueCount(job->getQueueCount() + 1);
-    EV << job << " queue count: " << job->getQueueCount() << endl;
+    EV_DEBUG << job << " queue count: " << job->getQueueCount() << endl;
+
+    if (importanceSampling && !wifiAvailable && !cellularPeriodTilted)
+        tiltCellularPeriod();
 
     // WIFI is OFF so add deadline to jobs
     if (!wifiAvailable) {
-        cMessage *deadlineMsg = new cMessage("deadline_reached");
-        deadlineMsg->setContextPointer(job);
-        job->setContextPointer(deadlineMsg);
-
-        simtime_t deadlineLength = par("deadlineDistribution").doubleValue();
+        simtime_t deadlineLength = deadlineVariate.draw();
         emit(deadlineDistrib, deadlineLength);
+        if (importanceSampling)
+            logLikelihoodRatio += std::log(deadlineVariate.likelihoodRatio(deadlineLength.dbl()));
         simtime_t deadlineTime = simTime() + deadlineLength;
-        EV << "Deadline set for job " << job << "; firing time: " << deadlineTime << endl;
-        scheduleAt(deadlineTime, deadlineMsg);
+        EV_DEBUG << "Deadline set for job " << job << "; firing time: " << deadlineTime << endl;
+        deadlines.insert(job, DeadlineKey{deadlineTime, deadlineSequence++});
+        rescheduleDeadlineTimer();
     }
 }
 
 simtime_t OffloadingQueue::startService(Job *job) {
-    EV << "Starting service of " << job->getName() << " - Current time: " << simTime() << endl;
+    EV_DEBUG << "Starting service of " << job->getName() << " - Current time: " << simTime() << endl;
 
     simtime_t delta = simTime() - job->getTimestamp();
     job->setTotalQueueingTime(job->getTotalQueueingTime() + delta);
     job->setTimestamp();
 
-    return par("serviceTime").doubleValue();
+    if (serviceTimeAttribute.empty())
+        return serviceTimeVariate.draw();
+
+    // drawn once for all the pipelines the job was replicated to
+    if (!job->hasPar(serviceTimeAttribute.c_str()))
+        throw cRuntimeError("%s has no %s attribute", job->getName(), serviceTimeAttribute.c_str());
+    return job->par(serviceTimeAttribute.c_str()).doubleValue();
 }
 
 void OffloadingQueue::endService(Job *job, int gateID) {
-    EV << "Finishing service of " << job->getName() << endl;
+    EV_DEBUG << "Finishing service of " << job->getName() << endl;
 
-    if (job->getContextPointer()) {
-        cMessage *deadlineMsg = (cMessage *)job->getContextPointer();
-        if (deadlineMsg->isScheduled())
-            cancelAndDelete(deadlineMsg);
-        job->setContextPointer(nullptr);
+    if (deadlines.contains(job)) {
+        deadlines.remove(job);
+        rescheduleDeadlineTimer();
     }
 
     simtime_t delta = simTime() - job->getTimestamp();
     job->setTotalServiceTime(job->getTotalServiceTime() + delta);
 
-    EV << job << " - queueing time: " << job->getTotalQueueingTime() << " - service time: " << job->getTotalServiceTime() << endl;
+    EV_DEBUG << job << " - queueing time: " << job->getTotalQueueingTime() << " - service time: " << job->getTotalServiceTime() << endl;
 
-    if (job->getKind() == 1)
+    if (job->getKind() == 1) {
+        if (isWifiFrozen())
+            jobsAfterTraceEnd++;
         emit(jobServiceTimeSignal, job->getTotalServiceTime());
+        if (streamingStatistics)
+            serviceTimeStats.collect(job->getTotalServiceTime().dbl());
+        // for a sink that cannot receive our signals (another partition)
+        if (!energyAttribute.empty() && powerCoefficient > 0)
+            job->addPar(energyAttribute.c_str()).setDoubleValue(powerCoefficient * job->getTotalServiceTime().dbl());
+    }
 
     send(job, "out", gateID);
 }
@@ -256,16 +394,18 @@ void OffloadingQueue::suspendService(Job *job) {
     simtime_t startTime = job->getTimestamp();
     simtime_t elapsedTime = simTime() - startTime;
     simtime_t remainingTime = curJobServiceTime - elapsedTime;
-    scheduleAt(nextStatusChangeTime + remainingTime, endServiceMsg);
+    // the end of a replayed trace never turns WiFi on again
+    if (nextStatusChangeTime != SimTime::getMaxTime())
+        scheduleAt(nextStatusChangeTime + remainingTime, endServiceMsg);
     job->setTotalServiceTime(job->getTotalServiceTime() + elapsedTime);
 
     job->setTimestamp();
     suspendedJob = job;
     servicedJob = nullptr;
-    EV << "Service SUSPENDED! Received: " << job << " - Suspended: " << suspendedJob << " - Serviced: " << servicedJob << endl;
-    EV << "Elapsed service time for " << job << ": " << elapsedTime << endl;
-    EV << "Remaining service time for " << job << ": " << remainingTime << endl;
-    EV << "New scheduleAt time: " << nextStatusChangeTime + remainingTime << endl;
+    EV_DEBUG << "Service SUSPENDED! Received: " << job << " - Suspended: " << suspendedJob << " - Serviced: " << servicedJob << endl;
+    EV_DEBUG << "Elapsed service time for " << job << ": " << elapsedTime << endl;
+    EV_DEBUG << "Remaining service time for " << job << ": " << remainingTime << endl;
+    EV_DEBUG << "New scheduleAt time: " << nextStatusChangeTime + remainingTime << endl;
 }
 
 void OffloadingQueue::resumeService(Job *job) {
@@ -274,14 +414,142 @@ void OffloadingQueue::resumeService(Job *job) {
     job->setTimestamp();
     servicedJob = job;
     suspendedJob = nullptr;
-    EV << "Service RESUMED! Received: " << job << " - Suspended: " << suspendedJob << " - Serviced: " << servicedJob << endl;
-    EV << "Current time: " << simTime() << endl;
+    EV_DEBUG << "Service RESUMED! Received: " << job << " - Suspended: " << suspendedJob << " - Serviced: " << servicedJob << endl;
+    EV_DEBUG << "Current time: " << simTime() << endl;
+}
+
+void OffloadingQueue::recordWifiAfterEnd() {
+    // a replay may need more WiFi transitions than this run, e.g. to drain
+    // the jobs of a longer deadline: go on with the periods for a while
+    if (!trace.isRecording() || trace.isReplaying() || !wifiStatusMsg->isScheduled())
+        return;
+    simtime_t end = simTime() + par("recordTraceMargin");
+    bool available = wifiAvailable;
+    for (simtime_t changeTime = nextStatusChangeTime; changeTime <= end; ) {
+        available = !available;
+        trace.recordWifiChange(available, changeTime);
+        changeTime += available ? wifiStateVariate.draw() : cellularStateVariate.draw();
+    }
 }
 
 void OffloadingQueue::finish() {
+    profile.record();
+    recordWifiAfterEnd();
+    trace.finish();
+    // the WiFi of a replayed trace (ours or of the ConnectivityProcess) ran out
+    if (isWifiFrozen()) {
+        recordScalar("trace:jobsAfterEnd", jobsAfterTraceEnd);
+        if (jobsAfterTraceEnd > 0)
+            EV_WARN << jobsAfterTraceEnd << " measured jobs left after the end of the WiFi trace, with WiFi frozen " << (wifiAvailable ? "ON" : "OFF") << ": record the trace with a larger recordTraceMargin" << endl;
+    }
+    if (!streamingStatistics)
+        return;
+
+    recordScalar("jobServiceTime:count", serviceTimeStats.getCount());
+    recordScalar("jobServiceTime:sum", serviceTimeStats.getSum(), "s");
+    recordScalar("jobServiceTime:mean", serviceTimeStats.getMean(), "s");
+    recordScalar("jobServiceTime:stddev", serviceTimeStats.getStddev(), "s");
+    recordScalar("energy:sum", powerCoefficient * serviceTimeStats.getSum(), "J");
+}
 
+
+
+
+
+void OffloadingQueue::saveJob(SnapshotWriter& out, Job *job) {
+    out.writeJob(job);
+    out.writeBool(deadlines.contains(job));
+    if (deadlines.contains(job)) {
+        out.writeTime(deadlines.getKey(job).time);
+        out.writeInt(deadlines.getKey(job).sequence);
+    }
 }
 
+Job *OffloadingQueue::restoreJob(SnapshotReader& in) {
+    Job *job = in.readJob();
+    if (in.readBool()) {
+        DeadlineKey key;
+        key.time = in.readTime();
+        key.sequence = in.readInt();
+        deadlines.insert(job, key);
+    }
+    return job;
+}
+
+void OffloadingQueue::saveState(SnapshotWriter& out) {
+    if (trace.isReplaying())
+        throw cRuntimeError("Snapshots of runs replaying a trace are not supported");
+    out.writeBool(wifiAvailable);
+    out.writeTime(nextStatusChangeTime);
+    out.writeTimer(wifiStatusMsg);
+    out.writeDuration(curJobServiceTime);
+    out.writeTimer(endServiceMsg);
+
+    out.writeBool(servicedJob != nullptr);
+    if (servicedJob)
+        saveJob(out, servicedJob);
+    out.writeBool(suspendedJob != nullptr);
+    if (suspendedJob)
+        saveJob(out, suspendedJob);
+
+    // heap order is enough, the keys give the serving order back
+    out.writeInt(queue.getLength());
+    for (const auto& entry : queue) {
+        saveJob(out, entry.item);
+        out.writeBool(entry.key.hasDeadline);
+        out.writeTime(entry.key.time);
+        out.writeInt(entry.key.sequence);
+    }
+    out.writeInt(queueSequence);
+    out.writeInt(deadlineSequence);
 
+    serviceTimeVariate.saveState(out);
+    deadlineVariate.saveState(out);
+    wifiStateVariate.saveState(out);
+    cellularStateVariate.saveState(out);
+}
 
+void OffloadingQueue::restoreState(SnapshotReader& in) {
+    Enter_Method_Silent();
+    if (servicedJob || suspendedJob || !queue.isEmpty())
+        throw cRuntimeError("Cannot restore a snapshot into a queue that already has jobs");
+    if (trace.isReplaying())
+        throw cRuntimeError("Snapshots of runs replaying a trace are not supported");
+
+    simtime_t arrivalTime;
+    wifiAvailable = in.readBool();
+    nextStatusChangeTime = in.readTime();
+    cancelEvent(wifiStatusMsg);
+    if (in.readTimer(arrivalTime))
+        scheduleAt(arrivalTime, wifiStatusMsg);
+    curJobServiceTime = in.readDuration();
+    cancelEvent(endServiceMsg);
+    if (in.readTimer(arrivalTime))
+        scheduleAt(arrivalTime, endServiceMsg);
+
+    if (in.readBool())
+        servicedJob = restoreJob(in);
+    if (in.readBool())
+        suspendedJob = restoreJob(in);
+
+    int64_t queued = in.readInt();
+    for (int64_t i = 0; i < queued; i++) {
+        Job *job = restoreJob(in);
+        QueueKey key;
+        key.hasDeadline = in.readBool();
+        key.time = in.readTime();
+        key.sequence = in.readInt();
+        queue.insert(job, key);
+    }
+    queueSequence = in.readInt();
+    deadlineSequence = in.readInt();
 
+    serviceTimeVariate.restoreState(in);
+    deadlineVariate.restoreState(in);
+    wifiStateVariate.restoreState(in);
+    cellularStateVariate.restoreState(in);
+
+    rescheduleDeadlineTimer();
+    emit(queueLengthSignal, length());
+    emit(busySignal, servicedJob != nullptr);
+}
@@ -8,14 +8,56 @@
 #ifndef OFFLOADINGQUEUE_H_
 #define OFFLOADINGQUEUE_H_
 
+#include <string>
+
 #include "QueueingDefs.h"
 #include "Queue.h"
 #include "Job.h"
+#include "IndexedHeap.h"
+#include "OffloadingMetrics.h"
+#include "Snapshot.h"
+#include "BatchedVariate.h"
+#include "EventProfile.h"
+#include "TraceStream.h"
 
 using namespace queueing;
 
 
-class QUEUEING_API OffloadingQueue : public cSimpleModule {
+class QUEUEING_API OffloadingQueue : public cSimpleModule, public Checkpointable {
+public:
+    /**
+     * Position of a waiting job: jobs with a deadline come first, ordered by
+     * deadline, then the others by creation time; sequence keeps insertion
+     * order among equal keys.
+     */
+    struct QueueKey {
+        bool hasDeadline;
+        simtime_t time;
+        long sequence;
+    };
+
+    /**
+     * Orders keys so that the next job to serve is on top of the heap: the
+     * smallest key for FIFO, the largest one for LIFO.
+     */
+    struct QueueKeyCompare {
+        bool lifo;
+        explicit QueueKeyCompare(bool lifo = false) : lifo(lifo) {}
+        bool operator()(const QueueKey& a, const QueueKey& b) const;
+    };
+
+    /**
+     * Pending deadline; sequence keeps the order in which deadlines with the
+     * same firing time were set.
+     */
+    struct DeadlineKey {
+        simtime_t time;
+        long sequence;
+        bool operator<(const DeadlineKey& other) const {
+            return time < other.time || (time == other.time && sequence < other.sequence);
+        }
+    };
+
 private:
     simsignal_t droppedSignal;
     simsignal_t queueLengthSignal;
@@ -26,30 +68,94 @@ private:
     simsignal_t cellActiveTime;
     simsignal_t deadlineDistrib;
     simsignal_t jobServiceTimeSignal;
+    simsignal_t wifiStatusSignal;
 
     Job *servicedJob;
     cMessage *endServiceMsg;
-    cQueue queue;
+    IndexedHeap<Job *, QueueKey, QueueKeyCompare> queue;
+    long queueSequence;
     int capacity;
     bool fifo;
 
+    // deadlines of the jobs in the module; only the earliest one is scheduled
+    IndexedHeap<Job *, DeadlineKey> deadlines;
+    cMessage *deadlineMsg;
+    long deadlineSequence;
+
     bool wifiAvailable;
     cMessage *wifiStatusMsg;
     Job *suspendedJob;
 
     Job *getFromQueue();
+    void insertIntoQueue(Job *job);
+    void rescheduleDeadlineTimer();
+
+    bool streamingStatistics;
+    double powerCoefficient;
+    RunningStatistic serviceTimeStats;
+    std::string serviceTimeAttribute;
+    std::string energyAttribute;
 
     simtime_t nextStatusChangeTime;
     simtime_t curJobServiceTime = SIMTIME_ZERO;
 
+    BatchedVariate serviceTimeVariate;
+    BatchedVariate deadlineVariate;
+    BatchedVariate wifiStateVariate;
+    BatchedVariate cellularStateVariate;
+    TraceStream trace;
+    long jobsAfterTraceEnd;     // measured jobs leaving once the replayed WiFi is frozen
+
+    // log likelihood ratio of the tilted draws (cellular periods, deadlines)
+    // since the last reset
+    bool importanceSampling;
+    double logLikelihoodRatio;
+    bool cellularPeriodTilted;
+
+    enum EventType { ARRIVAL_EVENT = 0, END_SERVICE_EVENT, DEADLINE_EVENT, WIFI_STATUS_EVENT };
+    EventProfile profile;
+
+    // emits are timed by the profile
+    template <typename T> void emit(simsignal_t signal, T value) {
+        EventProfile::EmitScope scope(profile);
+        cSimpleModule::emit(signal, value);
+    }
+
     void updateNextStatusChangeTime();
+    simtime_t drawCellularPeriod();
+    void tiltCellularPeriod();
+    bool isWifiFrozen() const { return nextStatusChangeTime == SimTime::getMaxTime(); }
+    void recordWifiAfterEnd();
     void prepareNextJobIfAny();
+    void scheduleEndService();
+
+    void handleJobArrival(Job *job);
+    void handleDeadline();
+    void handleWifiStatusChange();
+
+    void saveJob(SnapshotWriter& out, Job *job);
+    Job *restoreJob(SnapshotReader& in);
 
 public:
     OffloadingQueue();
     virtual ~OffloadingQueue();
     int length();
-    static int compareFunction(cObject *a, cObject *b);
+    bool isEmpty() const { return !servicedJob && !suspendedJob && queue.isEmpty(); }
+
+    // importance sampling: the cellular periods in which a job waits are
+    // tilted, from the arrival of the first one if the period started
+    // without. The log likelihood ratio of all the tilted draws restarts at
+    // every regeneration point; its value when a job leaves the system is
+    // the weight of the job. Reneged jobs are stamped with a reneged flag.
+    bool isImportanceSampling() const { return importanceSampling; }
+    double getLogLikelihoodRatio() const { return logLikelihoodRatio; }
+    void resetLikelihoodRatio() { logLikelihoodRatio = 0.0; }
+
+    // WiFi status set by a ConnectivityProcess; nextChange is the end of the new period
+    void changeWifiStatus(bool available, simtime_t nextChange);
+
+    virtual void saveState(SnapshotWriter& out) override;
+    virtual void restoreState(SnapshotReader& in) override;
 
 protected:
     virtual void initialize() override;
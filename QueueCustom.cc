@@ -37,11 +37,20 @@ void QueueCustom::initialize()
     queue.setName("queue");
 
     jobServiceTimeSignal = registerSignal("jobServiceTime");
+
+    streamingStatistics = par("streamingStatistics");
+    powerCoefficient = par("powerCoefficient");
+    serviceTimeStats.clear();
+    serviceTimeAttribute = par("serviceTimeAttribute").stdstringValue();
+    energyAttribute = par("energyAttribute").stdstringValue();
+    serviceTimeVariate.initialize(this, "serviceTime");
+    profile.initialize(this, { "arrival", "end_service" });
 }
 
 void QueueCustom::handleMessage(cMessage *msg)
 {
     if (msg == endServiceMsg) {
+        EventProfile::Scope scope(profile, END_SERVICE_EVENT);
         endService(jobServiced);
         if (queue.isEmpty()) {
             jobServiced = nullptr;
@@ -55,6 +64,7 @@ void QueueCustom::handleMessage(cMessage *msg)
         }
     }
     else {
+        EventProfile::Scope scope(profile, ARRIVAL_EVENT);
         Job *job = check_and_cast<Job *>(msg);
         arrival(job);
 
@@ -76,6 +86,7 @@ void QueueCustom::handleMessage(cMessage *msg)
                 return;
             }
             queue.insert(job);
+            profile.collectQueueLength(queue.getLength());
             emit(queueLengthSignal, length());
             // Removed queue count update to avoid duplicate data
         }
@@ -114,31 +125,86 @@ void QueueCustom::arrival(Job *job)
 
 simtime_t QueueCustom::startService(Job *job)
 {
-    EV << "Starting service of " << job->getName() << endl;
+    EV_DEBUG << "Starting service of " << job->getName() << endl;
 
     simtime_t delta = simTime() - job->getTimestamp();
     job->setTotalQueueingTime(job->getTotalQueueingTime() + delta);
     job->setTimestamp();
 
-    return par("serviceTime").doubleValue();
+    if (serviceTimeAttribute.empty())
+        return serviceTimeVariate.draw();
+
+    // drawn once for all the pipelines the job was replicated to
+    if (!job->hasPar(serviceTimeAttribute.c_str()))
+        throw cRuntimeError("%s has no %s attribute", job->getName(), serviceTimeAttribute.c_str());
+    return job->par(serviceTimeAttribute.c_str()).doubleValue();
 }
 
 void QueueCustom::endService(Job *job)
 {
-    EV << "Finishing service of " << job->getName() << endl;
+    EV_DEBUG << "Finishing service of " << job->getName() << endl;
 
     simtime_t delta = simTime() - job->getTimestamp();
     job->setTotalServiceTime(job->getTotalServiceTime() + delta);
     job->setTimestamp();
 
-    if (job->getKind() == 1)
+    if (job->getKind() == 1) {
         emit(jobServiceTimeSignal, delta);
+        if (streamingStatistics)
+            serviceTimeStats.collect(delta.dbl());
+        // for a sink that cannot receive our signals (another partition)
+        if (!energyAttribute.empty() && powerCoefficient > 0)
+            job->addPar(energyAttribute.c_str()).setDoubleValue(powerCoefficient * delta.dbl());
+    }
 
     send(job, "out");
 }
 
 void QueueCustom::finish()
 {
+    profile.record();
+    if (!streamingStatistics)
+        return;
+
+    recordScalar("jobServiceTime:count", serviceTimeStats.getCount());
+    recordScalar("jobServiceTime:sum", serviceTimeStats.getSum(), "s");
+    recordScalar("jobServiceTime:mean", serviceTimeStats.getMean(), "s");
+    recordScalar("jobServiceTime:stddev", serviceTimeStats.getStddev(), "s");
+    recordScalar("energy:sum", powerCoefficient * serviceTimeStats.getSum(), "J");
+}
 
+
+void QueueCustom::saveState(SnapshotWriter& out)
+{
+    out.writeTimer(endServiceMsg);
+    out.writeBool(jobServiced != nullptr);
+    if (jobServiced)
+        out.writeJob(jobServiced);
+    out.writeInt(queue.getLength());
+    for (int i = 0; i < queue.getLength(); i++)
+        out.writeJob(check_and_cast<Job *>(queue.get(i)));
+    serviceTimeVariate.saveState(out);
 }
 
+void QueueCustom::restoreState(SnapshotReader& in)
+{
+    Enter_Method_Silent();
+    if (jobServiced || !queue.isEmpty())
+        throw cRuntimeError("Cannot restore a snapshot into a queue that already has jobs");
+
+    simtime_t arrivalTime;
+    cancelEvent(endServiceMsg);
+    if (in.readTimer(arrivalTime))
+        scheduleAt(arrivalTime, endServiceMsg);
+    if (in.readBool())
+        jobServiced = in.readJob();
+
+    // from head to tail
+    int64_t queued = in.readInt();
+    for (int64_t i = 0; i < queued; i++)
+        queue.insert(in.readJob());
+    serviceTimeVariate.restoreState(in);
+
+    emit(queueLengthSignal, length());
+    emit(busySignal, jobServiced != nullptr);
+}
@@ -8,9 +8,15 @@
 #ifndef QUEUECUSTOM_H_
 #define QUEUECUSTOM_H_
 
+#include <string>
+
 #include "QueueingDefs.h"
 #include "Queue.h"
 #include "Job.h"
+#include "OffloadingMetrics.h"
+#include "Snapshot.h"
+#include "BatchedVariate.h"
+#include "EventProfile.h"
 
 using namespace queueing;
 
@@ -18,7 +24,7 @@ using namespace queueing;
 /**
  * Abstract base class for single-server queues.
  */
-class QUEUEING_API QueueCustom : public cSimpleModule
+class QUEUEING_API QueueCustom : public cSimpleModule, public Checkpointable
 {
     private:
         simsignal_t droppedSignal;
@@ -34,12 +40,32 @@ class QUEUEING_API QueueCustom : public cSimpleModule
         int capacity;
         bool fifo;
 
+        bool streamingStatistics;
+        double powerCoefficient;
+        RunningStatistic serviceTimeStats;
+        std::string serviceTimeAttribute;
+        std::string energyAttribute;
+        BatchedVariate serviceTimeVariate;
+
+        enum EventType { ARRIVAL_EVENT = 0, END_SERVICE_EVENT };
+        EventProfile profile;
+
+        // emits are timed by the profile
+        template <typename T> void emit(simsignal_t signal, T value) {
+            EventProfile::EmitScope scope(profile);
+            cSimpleModule::emit(signal, value);
+        }
+
         Job *getFromQueue();
 
     public:
         QueueCustom();
         virtual ~QueueCustom();
         int length();
+        bool isEmpty() const { return !jobServiced && queue.isEmpty(); }
+
+        virtual void saveState(SnapshotWriter& out) override;
+        virtual void restoreState(SnapshotReader& in) override;
 
     protected:
         virtual void initialize() override;
@@ -0,0 +1,146 @@
+/*
+ * Snapshot.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "Snapshot.h"
+
+#include <cstring>
+
+void SnapshotWriter::writeInt(int64_t value)
+{
+    // little endian, whatever the platform
+    unsigned char bytes[8];
+    for (int i = 0; i < 8; i++)
+        bytes[i] = (uint64_t)value >> (8 * i);
+    out.write((const char *)bytes, sizeof(bytes));
+}
+
+void SnapshotWriter::writeBool(bool value)
+{
+    out.put(value ? 1 : 0);
+}
+
+void SnapshotWriter::writeDouble(double value)
+{
+    int64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeInt(bits);
+}
+
+void SnapshotWriter::writeString(const std::string& value)
+{
+    writeInt(value.size());
+    out.write(value.data(), value.size());
+}
+
+void SnapshotWriter::writeTimer(const cMessage *timer)
+{
+    writeBool(timer && timer->isScheduled());
+    if (timer && timer->isScheduled())
+        writeTime(timer->getArrivalTime());
+}
+
+void SnapshotWriter::writeJob(Job *job)
+{
+    writeString(job->getName());
+    writeInt(job->getKind());
+    writeInt(job->getPriority());
+    writeTime(job->getTimestamp());
+    writeDuration(job->getTotalQueueingTime());
+    writeDuration(job->getTotalServiceTime());
+    writeDuration(job->getTotalDelayTime());
+    writeInt(job->getQueueCount());
+    writeInt(job->getDelayCount());
+    writeInt(job->getGeneration());
+
+    // attributes set by a JobReplicator
+    cArray& parameters = job->getParList();
+    int count = 0;
+    for (int i = 0; i < parameters.size(); i++)
+        if (dynamic_cast<cMsgPar *>(parameters.get(i)))
+            count++;
+    writeInt(count);
+    for (int i = 0; i < parameters.size(); i++) {
+        cMsgPar *parameter = dynamic_cast<cMsgPar *>(parameters.get(i));
+        if (parameter) {
+            writeString(parameter->getName());
+            writeDouble(parameter->doubleValue());
+        }
+    }
+}
+
+int64_t SnapshotReader::readInt()
+{
+    unsigned char bytes[8];
+    if (!in.read((char *)bytes, sizeof(bytes)))
+        throw cRuntimeError("Snapshot is truncated");
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++)
+        value |= (uint64_t)bytes[i] << (8 * i);
+    return (int64_t)value;
+}
+
+bool SnapshotReader::readBool()
+{
+    int value = in.get();
+    if (value == std::char_traits<char>::eof())
+        throw cRuntimeError("Snapshot is truncated");
+    return value != 0;
+}
+
+double SnapshotReader::readDouble()
+{
+    int64_t bits = readInt();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::string SnapshotReader::readString()
+{
+    int64_t size = readInt();
+    if (size < 0 || size > (1 << 30))
+        throw cRuntimeError("Snapshot is corrupted (string of %ld bytes)", (long)size);
+    std::string value(size, '\0');
+    if (size > 0 && !in.read(&value[0], size))
+        throw cRuntimeError("Snapshot is truncated");
+    return value;
+}
+
+bool SnapshotReader::readTimer(simtime_t& arrivalTime)
+{
+    if (!readBool())
+        return false;
+    arrivalTime = readTime();
+    return true;
+}
+
+Job *SnapshotReader::readJob()
+{
+    Job *job = new Job(readString().c_str());
+    job->setKind(readInt());
+    job->setPriority(readInt());
+    job->setTimestamp(readTime());
+    job->setTotalQueueingTime(readDuration());
+    job->setTotalServiceTime(readDuration());
+    job->setTotalDelayTime(readDuration());
+    job->setQueueCount(readInt());
+    job->setDelayCount(readInt());
+    job->setGeneration(readInt());
+
+    int64_t count = readInt();
+    for (int64_t i = 0; i < count; i++) {
+        std::string name = readString();
+        job->addPar(name.c_str()).setDoubleValue(readDouble());
+    }
+    return job;
+}
+
+void SnapshotReader::expectEnd()
+{
+    if (in.peek() != std::char_traits<char>::eof())
+        throw cRuntimeError("Snapshot record has unread data, it was saved by a different version of the model");
+}
@@ -0,0 +1,81 @@
+/*
+ * Snapshot.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+
+#include "QueueingDefs.h"
+#include "Job.h"
+
+using namespace queueing;
+
+/**
+ * Binary encoding of the state saved in a snapshot. Instants (timestamps,
+ * timer arrival times) and durations are kept apart: instants are stored as
+ * they are and shifted back by the save time when they are read, so the
+ * restored run starts at time zero.
+ */
+class QUEUEING_API SnapshotWriter
+{
+    private:
+        std::ostream& out;
+
+    public:
+        explicit SnapshotWriter(std::ostream& out) : out(out) {}
+
+        void writeInt(int64_t value);
+        void writeBool(bool value);
+        void writeDouble(double value);
+        void writeString(const std::string& value);
+        void writeTime(simtime_t instant) { writeInt(instant.raw()); }
+        void writeDuration(simtime_t duration) { writeInt(duration.raw()); }
+        // whether the timer is scheduled and when
+        void writeTimer(const cMessage *timer);
+        void writeJob(Job *job);
+};
+
+class QUEUEING_API SnapshotReader
+{
+    private:
+        std::istream& in;
+        simtime_t origin;
+
+    public:
+        SnapshotReader(std::istream& in, simtime_t origin) : in(in), origin(origin) {}
+
+        int64_t readInt();
+        bool readBool();
+        double readDouble();
+        std::string readString();
+        simtime_t readTime() { return SimTime().setRaw(readInt()) - origin; }
+        simtime_t readDuration() { return SimTime().setRaw(readInt()); }
+        // whether the timer was scheduled, and when
+        bool readTimer(simtime_t& arrivalTime);
+        // a new job, owned by the current module
+        Job *readJob();
+        // throws if the record has not been read completely
+        void expectEnd();
+};
+
+/**
+ * Modules whose state is saved by the SnapshotManager. restoreState() is
+ * called during initialization, after initialize() of every module.
+ */
+class QUEUEING_API Checkpointable
+{
+    public:
+        virtual ~Checkpointable() {}
+        virtual void saveState(SnapshotWriter& out) = 0;
+        virtual void restoreState(SnapshotReader& in) = 0;
+};
+
+#endif /* SNAPSHOT_H_ */
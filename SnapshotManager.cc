@@ -0,0 +1,159 @@
+/*
+ * SnapshotManager.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "SnapshotManager.h"
+#include "SnapshotRNG.h"
+
+#include <climits>
+#include <fstream>
+#include <sstream>
+
+Define_Module(SnapshotManager);
+
+namespace
+{
+    const char *SNAPSHOT_MAGIC = "SDSSNAP";
+    const int SNAPSHOT_VERSION = 2;
+}
+
+SnapshotManager::SnapshotManager()
+{
+    saveMsg = nullptr;
+}
+
+SnapshotManager::~SnapshotManager()
+{
+    cancelAndDelete(saveMsg);
+}
+
+void SnapshotManager::initialize(int stage)
+{
+    // the other modules are initialized in stage 0
+    if (stage != 1)
+        return;
+
+    if (!par("restoreFile").stdstringValue().empty())
+        restore();
+
+    if (!par("saveFile").stdstringValue().empty()) {
+        simtime_t warmup = getSimulation()->getWarmupPeriod();
+        simtime_t saveTime = par("saveTime").doubleValue() < 0 ? warmup : par("saveTime");
+        // measured results are not part of the snapshot
+        if (saveTime <= SIMTIME_ZERO || saveTime > warmup)
+            throw cRuntimeError("saveTime must be within the warmup period (0, %s]", warmup.str().c_str());
+
+        // after everything else happening at the same time
+        saveMsg = new cMessage("save_snapshot");
+        saveMsg->setSchedulingPriority(SHRT_MAX);
+        scheduleAt(saveTime, saveMsg);
+    }
+}
+
+void SnapshotManager::handleMessage(cMessage *msg)
+{
+    ASSERT(msg == saveMsg);
+    save();
+    if (par("endAfterSave").boolValue())
+        endSimulation();
+}
+
+void SnapshotManager::collectCheckpointable(cModule *module, std::vector<cModule *>& modules)
+{
+    if (dynamic_cast<Checkpointable *>(module))
+        modules.push_back(module);
+    for (cModule::SubmoduleIterator it(module); !it.end(); ++it)
+        collectCheckpointable(*it, modules);
+}
+
+void SnapshotManager::save()
+{
+    const char *fileName = par("saveFile").stringValue();
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw cRuntimeError("Cannot write snapshot %s", fileName);
+
+    SnapshotWriter out(file);
+    out.writeString(SNAPSHOT_MAGIC);
+    out.writeInt(SNAPSHOT_VERSION);
+    out.writeInt(SimTime::getScaleExp());
+    out.writeString(getSimulation()->getSystemModule()->getNedTypeName());
+    out.writeTime(simTime());
+
+    int numRngs = getEnvir()->getNumRNGs();
+    out.writeInt(numRngs);
+    for (int i = 0; i < numRngs; i++) {
+        SnapshotRNG *rng = dynamic_cast<SnapshotRNG *>(getEnvir()->getRNG(i));
+        if (!rng)
+            throw cRuntimeError("Snapshots need rng-class = \"SnapshotRNG\"");
+        rng->saveState(out);
+    }
+
+    std::vector<cModule *> modules;
+    collectCheckpointable(getSimulation()->getSystemModule(), modules);
+    out.writeInt(modules.size());
+    for (cModule *module : modules) {
+        // every module has its own record, so a reader can check it used it all
+        std::ostringstream record;
+        SnapshotWriter recordOut(record);
+        dynamic_cast<Checkpointable *>(module)->saveState(recordOut);
+        out.writeString(module->getFullPath());
+        out.writeString(record.str());
+    }
+
+    if (!file.flush())
+        throw cRuntimeError("Cannot write snapshot %s", fileName);
+    EV_INFO << "Saved the state of " << modules.size() << " modules and " << numRngs << " RNGs to " << fileName << " at " << simTime() << endl;
+}
+
+void SnapshotManager::restore()
+{
+    const char *fileName = par("restoreFile").stringValue();
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file)
+        throw cRuntimeError("Cannot read snapshot %s", fileName);
+
+    SnapshotReader in(file, SIMTIME_ZERO);
+    if (in.readString() != SNAPSHOT_MAGIC || in.readInt() != SNAPSHOT_VERSION)
+        throw cRuntimeError("%s is not a snapshot of this version of the model", fileName);
+    if (in.readInt() != SimTime::getScaleExp())
+        throw cRuntimeError("%s was saved with a different simtime-resolution", fileName);
+    std::string network = in.readString();
+    if (network != getSimulation()->getSystemModule()->getNedTypeName())
+        throw cRuntimeError("%s is a snapshot of %s", fileName, network.c_str());
+    simtime_t saveTime = in.readTime();
+
+    int numRngs = in.readInt();
+    if (numRngs != getEnvir()->getNumRNGs())
+        throw cRuntimeError("%s has %d RNGs, the run has %d", fileName, numRngs, getEnvir()->getNumRNGs());
+    for (int i = 0; i < numRngs; i++) {
+        SnapshotRNG *rng = dynamic_cast<SnapshotRNG *>(getEnvir()->getRNG(i));
+        if (!rng)
+            throw cRuntimeError("Snapshots need rng-class = \"SnapshotRNG\"");
+        rng->restoreState(in);
+    }
+
+    std::vector<cModule *> modules;
+    collectCheckpointable(getSimulation()->getSystemModule(), modules);
+    int count = in.readInt();
+    if (count != (int)modules.size())
+        throw cRuntimeError("%s has the state of %d modules, the network has %d", fileName, count, (int)modules.size());
+
+    for (int i = 0; i < count; i++) {
+        std::string path = in.readString();
+        std::istringstream record(in.readString());
+        cModule *module = getSimulation()->getModuleByPath(path.c_str());
+        if (!module || !dynamic_cast<Checkpointable *>(module))
+            throw cRuntimeError("%s has the state of %s, which is not in the network", fileName, path.c_str());
+
+        // times are shifted so that the run starts where the snapshot was taken
+        SnapshotReader recordIn(record, saveTime);
+        dynamic_cast<Checkpointable *>(module)->restoreState(recordIn);
+        recordIn.expectEnd();
+    }
+    in.expectEnd();
+    EV_INFO << "Restored the state of " << count << " modules and " << numRngs << " RNGs from " << fileName << ", saved at " << saveTime << endl;
+}
@@ -0,0 +1,40 @@
+/*
+ * SnapshotManager.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef SNAPSHOTMANAGER_H_
+#define SNAPSHOTMANAGER_H_
+
+#include <vector>
+
+#include "QueueingDefs.h"
+#include "Snapshot.h"
+
+/**
+ * Saves the state of the Checkpointable modules and of the RNGs at the end
+ * of the warmup, or restores it at the beginning of the run. See NED file
+ * for more info.
+ */
+class QUEUEING_API SnapshotManager : public cSimpleModule
+{
+    private:
+        cMessage *saveMsg;
+
+        void collectCheckpointable(cModule *module, std::vector<cModule *>& modules);
+        void save();
+        void restore();
+
+    public:
+        SnapshotManager();
+        virtual ~SnapshotManager();
+
+    protected:
+        virtual int numInitStages() const override { return 2; }
+        virtual void initialize(int stage) override;
+        virtual void handleMessage(cMessage *msg) override;
+};
+
+#endif /* SNAPSHOTMANAGER_H_ */
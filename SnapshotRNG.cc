@@ -0,0 +1,28 @@
+/*
+ * SnapshotRNG.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "SnapshotRNG.h"
+
+Register_Class(SnapshotRNG);
+
+void SnapshotRNG::saveState(SnapshotWriter& out) const
+{
+    uint32_t state[MTRand::SAVE];
+    rand.save(state);
+    out.writeInt(numDrawn);
+    for (uint32_t word : state)
+        out.writeInt(word);
+}
+
+void SnapshotRNG::restoreState(SnapshotReader& in)
+{
+    uint32_t state[MTRand::SAVE];
+    numDrawn = in.readInt();
+    for (uint32_t& word : state)
+        word = in.readInt();
+    rand.load(state);
+}
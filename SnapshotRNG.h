@@ -0,0 +1,25 @@
+/*
+ * SnapshotRNG.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef SNAPSHOTRNG_H_
+#define SNAPSHOTRNG_H_
+
+#include "QueueingDefs.h"
+#include "Snapshot.h"
+
+/**
+ * The default Mersenne Twister of OMNeT++ (same seeds, same numbers), whose
+ * state can be saved in a snapshot. Select it with rng-class = "SnapshotRNG".
+ */
+class QUEUEING_API SnapshotRNG : public cMersenneTwister
+{
+    public:
+        void saveState(SnapshotWriter& out) const;
+        void restoreState(SnapshotReader& in);
+};
+
+#endif /* SNAPSHOTRNG_H_ */
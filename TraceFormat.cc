@@ -0,0 +1,263 @@
+/*
+ * TraceFormat.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "TraceFormat.h"
+#include "ColumnarVectorFormat.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using ColumnarVectorFormat::putFixed;
+using ColumnarVectorFormat::putSignedVarint;
+using ColumnarVectorFormat::putDouble;
+
+namespace TraceFormat
+{
+    Writer::Writer(size_t bufferSize)
+    {
+        file = nullptr;
+        this->bufferSize = std::max<size_t>(bufferSize, MAX_RECORD_SIZE);
+        lastTime = 0;
+        records = 0;
+    }
+
+    Writer::~Writer()
+    {
+        // errors are only reported by close()
+        if (file) {
+            fwrite(buffer.data(), 1, buffer.size(), file);
+            fclose(file);
+        }
+    }
+
+    void Writer::open(const std::string& fileName, int scaleExp)
+    {
+        file = fopen(fileName.c_str(), "wb");
+        if (!file)
+            throw std::runtime_error("cannot open " + fileName + " for writing");
+        this->fileName = fileName;
+        lastTime = 0;
+        records = 0;
+
+        buffer.assign(FILE_MAGIC, sizeof(FILE_MAGIC));
+        putFixed(buffer, VERSION, 4);
+        putFixed(buffer, (uint32_t)scaleExp, 4);
+    }
+
+    void Writer::write(const Record& record)
+    {
+        buffer.push_back((char)record.kind);
+        putSignedVarint(buffer, record.time - lastTime);
+        if (record.kind == SIZED_ARRIVAL)
+            putDouble(buffer, record.size);
+        lastTime = record.time;
+        records++;
+
+        if (buffer.size() >= bufferSize) {
+            if (fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size())
+                throw std::runtime_error("cannot write " + fileName);
+            buffer.clear();
+        }
+    }
+
+    void Writer::flush()
+    {
+        if (!file)
+            return;
+        if (fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size() || fflush(file) != 0)
+            throw std::runtime_error("cannot write " + fileName);
+        buffer.clear();
+    }
+
+    void Writer::close()
+    {
+        if (!file)
+            return;
+        bool written = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+        buffer.clear();
+        written = fclose(file) == 0 && written;
+        file = nullptr;
+        if (!written)
+            throw std::runtime_error("cannot write " + fileName);
+    }
+
+    Reader::Reader(size_t readAhead)
+    {
+        scaleExp = 0;
+        lastTime = 0;
+        records = 0;
+        this->readAhead = std::max<size_t>(readAhead, 4 * MAX_RECORD_SIZE);
+        data = nullptr;
+        dataSize = 0;
+        position = 0;
+        dataOffset = 0;
+        fileSize = 0;
+#ifdef _WIN32
+        file = nullptr;
+#else
+        fd = -1;
+        mapping = nullptr;
+        released = 0;
+        advisedUntil = 0;
+#endif
+    }
+
+    Reader::~Reader()
+    {
+        close();
+    }
+
+    void Reader::open(const std::string& fileName)
+    {
+        close();
+        lastTime = 0;
+        records = 0;
+        position = 0;
+        dataOffset = 0;
+
+#ifdef _WIN32
+        file = fopen(fileName.c_str(), "rb");
+        if (!file)
+            throw std::runtime_error("cannot open " + fileName);
+        if (fseek(file, 0, SEEK_END) != 0)
+            throw std::runtime_error("cannot read " + fileName);
+        fileSize = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        window.clear();
+        data = nullptr;
+        dataSize = 0;
+#else
+        fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("cannot open " + fileName);
+        struct stat status;
+        if (fstat(fd, &status) != 0) {
+            close();
+            throw std::runtime_error("cannot read " + fileName);
+        }
+        fileSize = status.st_size;
+        if (fileSize > 0) {
+            // only a reservation of addresses: pages are read when touched
+            mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                mapping = nullptr;
+                close();
+                throw std::runtime_error("cannot map " + fileName);
+            }
+            madvise(mapping, fileSize, MADV_SEQUENTIAL);
+        }
+        data = (const unsigned char *)mapping;
+        dataSize = fileSize;
+        released = 0;
+        advisedUntil = 0;
+#endif
+        this->fileName = fileName;
+        readHeader();
+    }
+
+    void Reader::readHeader()
+    {
+        if (!fill() || dataSize - position < HEADER_SIZE || std::memcmp(data + position, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+            std::string name = fileName;
+            close();
+            throw std::runtime_error(name + " is not a trace");
+        }
+        ColumnarVectorFormat::Cursor in(data + position + sizeof(FILE_MAGIC), HEADER_SIZE - sizeof(FILE_MAGIC));
+        uint32_t version = in.getFixed(4);
+        scaleExp = (int32_t)in.getFixed(4);
+        if (version != VERSION) {
+            std::string name = fileName;
+            close();
+            throw std::runtime_error(name + " has trace version " + std::to_string(version) + ", " + std::to_string(VERSION) + " expected");
+        }
+        position += HEADER_SIZE;
+    }
+
+    bool Reader::fill()
+    {
+#ifdef _WIN32
+        size_t available = dataSize - position;
+        if (available < MAX_RECORD_SIZE && dataOffset + dataSize < fileSize) {
+            // the partial record at the end of the window moves to its front
+            std::vector<unsigned char> next(available + readAhead);
+            std::copy(window.begin() + position, window.begin() + dataSize, next.begin());
+            size_t count = fread(next.data() + available, 1, readAhead, file);
+            dataOffset += position;
+            dataSize = available + count;
+            position = 0;
+            window.swap(next);
+            data = window.data();
+        }
+#else
+        if (position + readAhead / 2 >= advisedUntil && advisedUntil < dataSize) {
+            static const size_t pageSize = sysconf(_SC_PAGESIZE);
+            size_t start = position / pageSize * pageSize;
+            char *base = (char *)mapping;
+            if (start > released) {
+                madvise(base + released, start - released, MADV_DONTNEED);
+                released = start;
+            }
+            advisedUntil = std::min(dataSize, start + readAhead);
+            madvise(base + start, advisedUntil - start, MADV_WILLNEED);
+        }
+#endif
+        return position < dataSize;
+    }
+
+    bool Reader::next(Record& record)
+    {
+        if (!isOpen() || !fill())
+            return false;
+
+        ColumnarVectorFormat::Cursor in(data + position, dataSize - position);
+        try {
+            uint8_t kind = in.getFixed(1);
+            if (kind < ARRIVAL || kind > WIFI_OFF)
+                throw std::runtime_error("unknown record kind");
+            record.kind = (RecordKind)kind;
+            record.time = lastTime + in.getSignedVarint();
+            record.size = kind == SIZED_ARRIVAL ? in.getDouble() : std::numeric_limits<double>::quiet_NaN();
+        }
+        catch (const std::runtime_error& e) {
+            throw std::runtime_error(fileName + ": malformed record at offset " + std::to_string(dataOffset + position));
+        }
+        position = dataSize - in.remaining();
+        lastTime = record.time;
+        records++;
+        return true;
+    }
+
+    void Reader::close()
+    {
+#ifdef _WIN32
+        if (file)
+            fclose(file);
+        file = nullptr;
+        window.clear();
+#else
+        if (mapping)
+            munmap(mapping, fileSize);
+        if (fd >= 0)
+            ::close(fd);
+        mapping = nullptr;
+        fd = -1;
+#endif
+        data = nullptr;
+        dataSize = 0;
+        position = 0;
+        fileName.clear();
+    }
+}
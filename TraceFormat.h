@@ -0,0 +1,123 @@
+/*
+ * TraceFormat.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ *
+ * Compact binary trace of job arrivals (with their sizes) and WiFi on/off
+ * transitions, replayed by LimitedSource, OffloadingQueue and
+ * ConnectivityProcess through TraceStream, and written by them or by
+ * analysis/traces.py from device logs. It does not depend on OMNeT++.
+ *
+ * Layout (integers are little endian, varints as in ColumnarVectorFormat.h):
+ *
+ *   header   "SDSTRACE", u32 version, i32 simtime scale exponent
+ *   records  u8 kind, signed varint time delta from the previous record
+ *            (the first one from 0), as raw simtime values at the scale of
+ *            the header, then f64 size in seconds for SIZED_ARRIVAL
+ *
+ * Records are in time order, the kinds interleaved; there is no index, so
+ * a trace can be written and read as a stream.
+ */
+
+#ifndef TRACEFORMAT_H_
+#define TRACEFORMAT_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace TraceFormat
+{
+    const char FILE_MAGIC[8] = { 'S', 'D', 'S', 'T', 'R', 'A', 'C', 'E' };
+    const uint32_t VERSION = 1;
+    const size_t HEADER_SIZE = 16;
+    const size_t MAX_RECORD_SIZE = 1 + 10 + 8;
+
+    enum RecordKind : uint8_t { ARRIVAL = 1, SIZED_ARRIVAL, WIFI_ON, WIFI_OFF };
+
+    struct Record {
+        RecordKind kind;
+        int64_t time;       // raw simtime at the scale of the trace
+        double size;        // s, SIZED_ARRIVAL only
+    };
+
+    /**
+     * Appends records to a trace, through a buffer of bufferSize bytes.
+     */
+    class Writer
+    {
+        private:
+            FILE *file;
+            std::string fileName;
+            std::string buffer;
+            size_t bufferSize;
+            int64_t lastTime;
+            uint64_t records;
+
+        public:
+            explicit Writer(size_t bufferSize = 1 << 16);
+            ~Writer();
+
+            void open(const std::string& fileName, int scaleExp);
+            bool isOpen() const { return file != nullptr; }
+            const std::string& getFileName() const { return fileName; }
+            uint64_t getRecordCount() const { return records; }
+            void write(const Record& record);
+            void flush();
+            void close();
+    };
+
+    /**
+     * Sequential cursor over a trace. The file is memory mapped and never
+     * read as a whole: the next readAhead bytes are requested in advance
+     * (MADV_WILLNEED) and the pages already read are released, so the
+     * resident memory stays around readAhead whatever the trace length.
+     * Where mmap is not available the same window is read with fread.
+     */
+    class Reader
+    {
+        private:
+            std::string fileName;
+            int scaleExp;
+            int64_t lastTime;
+            uint64_t records;
+            size_t readAhead;
+
+            const unsigned char *data;  // window of the file starting at dataOffset
+            size_t dataSize;
+            size_t position;            // next record, inside the window
+            uint64_t dataOffset;
+            uint64_t fileSize;
+
+#ifdef _WIN32
+            FILE *file;
+            std::vector<unsigned char> window;
+#else
+            int fd;
+            void *mapping;
+            size_t released;            // pages before this offset were given back
+            size_t advisedUntil;
+#endif
+
+            void readHeader();
+            // makes the next record available in the window, false at the end of the file
+            bool fill();
+
+        public:
+            explicit Reader(size_t readAhead = 1 << 20);
+            ~Reader();
+
+            void open(const std::string& fileName);
+            bool isOpen() const { return !fileName.empty(); }
+            const std::string& getFileName() const { return fileName; }
+            int getScaleExp() const { return scaleExp; }
+            uint64_t getRecordCount() const { return records; }
+            // false at the end of the trace
+            bool next(Record& record);
+            void close();
+    };
+}
+
+#endif /* TRACEFORMAT_H_ */
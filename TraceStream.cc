@@ -0,0 +1,164 @@
+/*
+ * TraceStream.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "TraceStream.h"
+
+#include <cmath>
+#include <stdexcept>
+
+std::map<std::string, std::weak_ptr<TraceFormat::Writer>> TraceStream::writers;
+
+TraceStream::TraceStream()
+{
+    owner = nullptr;
+    replayed = 0;
+    recorded = 0;
+    maxTraceTime = 0;
+    exhausted = false;
+}
+
+void TraceStream::initialize(cComponent *owner, const char *replayParameter, const char *recordParameter)
+{
+    this->owner = owner;
+    replayed = 0;
+    recorded = 0;
+    exhausted = false;
+    std::string replayFile = owner->par(replayParameter).stdstringValue();
+    std::string recordFile = owner->par(recordParameter).stdstringValue();
+    if (!replayFile.empty() && replayFile == recordFile)
+        throw cRuntimeError(owner, "%s and %s name the same trace %s", replayParameter, recordParameter, replayFile.c_str());
+
+    try {
+        if (!replayFile.empty()) {
+            reader.open(replayFile);
+            // times at a finer scale than the simulation are only rounded,
+            // at a coarser one they are multiplied and may overflow
+            maxTraceTime = SimTime::getMaxTime().raw();
+            for (int exp = SimTime::getScaleExp(); exp < reader.getScaleExp() && maxTraceTime > 0; exp++)
+                maxTraceTime /= 10;
+        }
+        if (!recordFile.empty()) {
+            writer = writers[recordFile].lock();
+            if (!writer) {
+                writer = std::make_shared<TraceFormat::Writer>();
+                writer->open(recordFile, SimTime::getScaleExp());
+                writers[recordFile] = writer;
+            }
+        }
+    }
+    catch (const std::runtime_error& e) {
+        throw cRuntimeError(owner, "%s", e.what());
+    }
+}
+
+simtime_t TraceStream::toSimTime(int64_t time) const
+{
+    if (time < 0 || time > maxTraceTime)
+        throw cRuntimeError(owner, "Trace %s: time %llde%d s is outside the simtime range [0, %s] of simtime-scale %d, use a coarser simtime-scale",
+                reader.getFileName().c_str(), (long long)time, reader.getScaleExp(), SimTime::getMaxTime().str().c_str(), SimTime::getScaleExp());
+    if (reader.getScaleExp() == SimTime::getScaleExp())
+        return SimTime().setRaw(time);
+    return SimTime(time, (SimTimeUnit)reader.getScaleExp());
+}
+
+bool TraceStream::nextArrival(simtime_t& time, double& size)
+{
+    TraceFormat::Record record;
+    try {
+        while (reader.next(record)) {
+            if (record.kind != TraceFormat::ARRIVAL && record.kind != TraceFormat::SIZED_ARRIVAL)
+                continue;
+            time = toSimTime(record.time);
+            if (time < simTime())
+                throw cRuntimeError(owner, "Trace %s goes back in time: arrival at %s", reader.getFileName().c_str(), time.str().c_str());
+            size = record.size;
+            replayed++;
+            return true;
+        }
+    }
+    catch (const std::runtime_error& e) {
+        throw cRuntimeError(owner, "%s", e.what());
+    }
+    setExhausted();
+    return false;
+}
+
+bool TraceStream::nextWifiChange(bool available, simtime_t& time)
+{
+    TraceFormat::Record record;
+    try {
+        while (reader.next(record)) {
+            // device logs may repeat a state
+            if (record.kind != (available ? TraceFormat::WIFI_ON : TraceFormat::WIFI_OFF))
+                continue;
+            time = toSimTime(record.time);
+            if (time < simTime())
+                throw cRuntimeError(owner, "Trace %s goes back in time: WiFi %s at %s", reader.getFileName().c_str(), available ? "on" : "off", time.str().c_str());
+            replayed++;
+            return true;
+        }
+    }
+    catch (const std::runtime_error& e) {
+        throw cRuntimeError(owner, "%s", e.what());
+    }
+    setExhausted();
+    return false;
+}
+
+void TraceStream::setExhausted()
+{
+    if (!exhausted) {
+        exhausted = true;
+        exhaustedAt = simTime();
+    }
+}
+
+void TraceStream::record(TraceFormat::RecordKind kind, simtime_t time, double size)
+{
+    try {
+        writer->write(TraceFormat::Record{kind, time.raw(), size});
+    }
+    catch (const std::runtime_error& e) {
+        throw cRuntimeError(owner, "%s", e.what());
+    }
+    recorded++;
+}
+
+void TraceStream::recordArrival(simtime_t time, double size)
+{
+    if (writer)
+        record(std::isnan(size) ? TraceFormat::ARRIVAL : TraceFormat::SIZED_ARRIVAL, time, size);
+}
+
+void TraceStream::recordWifiChange(bool available, simtime_t time)
+{
+    if (writer)
+        record(available ? TraceFormat::WIFI_ON : TraceFormat::WIFI_OFF, time, 0);
+}
+
+void TraceStream::finish()
+{
+    if (isReplaying()) {
+        owner->recordScalar("trace:replayed", replayed);
+        if (exhausted)
+            owner->recordScalar("trace:exhaustedAt", exhaustedAt, "s");
+        reader.close();
+    }
+    if (isRecording()) {
+        owner->recordScalar("trace:recorded", recorded);
+        try {
+            if (writer.use_count() == 1)
+                writer->close();
+            else
+                writer->flush();
+        }
+        catch (const std::runtime_error& e) {
+            throw cRuntimeError(owner, "%s", e.what());
+        }
+        writer.reset();
+    }
+}
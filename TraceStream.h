@@ -0,0 +1,72 @@
+/*
+ * TraceStream.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef TRACESTREAM_H_
+#define TRACESTREAM_H_
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "QueueingDefs.h"
+#include "TraceFormat.h"
+
+/**
+ * Trace of a module (see TraceFormat.h), named by two string parameters:
+ * the trace replayed instead of drawing arrivals or WiFi periods, and the
+ * trace the module records. Either may be empty.
+ *
+ * Every module has a cursor of its own over the replayed trace and skips
+ * the records of the other modules, so the source and the WiFi queue can
+ * replay the same file. Modules recording to the same file share its
+ * writer; records are appended when the arrival or transition happens, so
+ * the file stays in time order.
+ */
+class QUEUEING_API TraceStream
+{
+    private:
+        cComponent *owner;
+        TraceFormat::Reader reader;
+        std::shared_ptr<TraceFormat::Writer> writer;
+        long replayed;
+        long recorded;
+        int64_t maxTraceTime;   // largest time of the replayed trace that fits in a simtime
+        bool exhausted;
+        simtime_t exhaustedAt;  // the module asked past the last record of its kinds
+
+        // writers by file name, alive while a module records to them
+        static std::map<std::string, std::weak_ptr<TraceFormat::Writer>> writers;
+
+        simtime_t toSimTime(int64_t time) const;
+        void record(TraceFormat::RecordKind kind, simtime_t time, double size);
+        void setExhausted();
+
+    public:
+        TraceStream();
+
+        void initialize(cComponent *owner, const char *replayParameter, const char *recordParameter);
+        bool isReplaying() const { return reader.isOpen(); }
+        bool isRecording() const { return writer != nullptr; }
+        bool isExhausted() const { return exhausted; }
+
+        // next arrival of the trace; size is NaN when the trace has none.
+        // False at the end of the trace.
+        bool nextArrival(simtime_t& time, double& size);
+        // next transition to available, skipping those to the current state
+        bool nextWifiChange(bool available, simtime_t& time);
+
+        // no-ops unless recording
+        void recordArrival(simtime_t time, double size);
+        void recordWifiChange(bool available, simtime_t time);
+
+        // records trace:replayed, trace:exhaustedAt (if the trace ran out) and
+        // trace:recorded, and closes the recorded trace when no other module
+        // writes it
+        void finish();
+};
+
+#endif /* TRACESTREAM_H_ */
@@ -0,0 +1,81 @@
+/*
+ * WindowStatsRecorder.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "WindowStatsRecorder.h"
+
+Register_ResultRecorder("windowStats", WindowStatsRecorder);
+
+Register_PerObjectConfigOptionU(CFGID_WINDOW_LENGTH, "window-length", KIND_STATISTIC, "s", "100s", "Length of the simulation time windows of the windowStats result recorder");
+
+WindowStatsRecorder::WindowStatsRecorder()
+{
+    window = -1;
+    count = 0;
+    sum = 0.0;
+    min = max = 0.0;
+    for (int i = 0; i < OUTPUTS; i++)
+        handles[i] = nullptr;
+}
+
+void WindowStatsRecorder::registerVectors()
+{
+    // the component is only known once the recorder is attached to it
+    std::string statistic = getComponent()->getFullPath() + "." + getStatisticName();
+    windowLength = getEnvir()->getConfig()->getAsDouble(statistic.c_str(), CFGID_WINDOW_LENGTH);
+    if (windowLength <= SIMTIME_ZERO)
+        throw cRuntimeError("window-length of %s must be positive", statistic.c_str());
+
+    static const char *suffixes[OUTPUTS] = { "windowCount", "windowMean", "windowMin", "windowMax" };
+    auto attributes = getStatisticAttributes();
+    std::string module = getComponent()->getFullPath();
+    for (int i = 0; i < OUTPUTS; i++) {
+        std::string name = std::string(getStatisticName()) + ":" + suffixes[i];
+        handles[i] = getEnvir()->registerOutputVector(module.c_str(), name.c_str());
+        for (const auto& attribute : attributes) {
+            if (i == COUNT && attribute.first == "unit")
+                continue;
+            getEnvir()->setVectorAttribute(handles[i], attribute.first.c_str(), attribute.second.c_str());
+        }
+        getEnvir()->setVectorAttribute(handles[i], "interpolationmode", "none");
+    }
+}
+
+void WindowStatsRecorder::collect(simtime_t_cref t, double value, cObject *details)
+{
+    if (!handles[COUNT])
+        registerVectors();
+
+    int64_t index = t.raw() / windowLength.raw();
+    if (index != window) {
+        recordWindow();
+        window = index;
+    }
+
+    if (count == 0 || value < min) min = value;
+    if (count == 0 || value > max) max = value;
+    sum += value;
+    count++;
+}
+
+void WindowStatsRecorder::recordWindow()
+{
+    if (count == 0)
+        return;
+
+    simtime_t start = windowLength * window;
+    getEnvir()->recordInOutputVector(handles[COUNT], start, count);
+    getEnvir()->recordInOutputVector(handles[MEAN], start, sum / count);
+    getEnvir()->recordInOutputVector(handles[MIN], start, min);
+    getEnvir()->recordInOutputVector(handles[MAX], start, max);
+    count = 0;
+    sum = 0.0;
+}
+
+void WindowStatsRecorder::finish(cResultFilter *prev)
+{
+    recordWindow();
+}
@@ -0,0 +1,47 @@
+/*
+ * WindowStatsRecorder.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef WINDOWSTATSRECORDER_H_
+#define WINDOWSTATSRECORDER_H_
+
+#include "QueueingDefs.h"
+
+/**
+ * Result recorder that splits simulation time into windows of fixed length
+ * (the window-length option of the statistic, e.g.
+ * **.jobServiceTime.window-length = 100s) and records, instead of every
+ * sample, the count, mean, min and max of the samples of each window as the
+ * vectors <statistic>:windowCount, :windowMean, :windowMin and :windowMax.
+ * Windows start at time 0 and are stamped with their start time; windows
+ * without samples are not recorded. Use it with record=windowStats in
+ * @statistic or with result-recording-modes.
+ */
+class QUEUEING_API WindowStatsRecorder : public cNumericResultRecorder
+{
+    private:
+        enum Output { COUNT = 0, MEAN, MIN, MAX, OUTPUTS };
+
+        simtime_t windowLength;
+        int64_t window;           // index of the current window, -1 before the first sample
+        long count;
+        double sum;
+        double min;
+        double max;
+        void *handles[OUTPUTS];
+
+        void registerVectors();
+        void recordWindow();
+
+    protected:
+        virtual void collect(simtime_t_cref t, double value, cObject *details) override;
+        virtual void finish(cResultFilter *prev) override;
+
+    public:
+        WindowStatsRecorder();
+};
+
+#endif /* WINDOWSTATSRECORDER_H_ */
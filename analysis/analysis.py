@@ -3,7 +3,6 @@
 import argparse
 import numpy as np
 import os
-import copy
 import scipy.stats as stats
 from utils import filterData, setupPlots, loadData, plotGraph, getTupleValues
 
@@ -11,7 +10,7 @@ from utils import filterData, setupPlots, loadData, plotGraph, getTupleValues
 def computeMeanResponseTime(data, keys, outputDir):
 	print("Plotting Mean Response Time...")
 	
-	responseData = copy.deepcopy(data)
+	responseData = {}
 	mrtData = []
 	confidenceValues = {}
 	
@@ -59,7 +58,7 @@ def computeMeanEnergyConsumption(data, keys, outputDir):
 	
 	wifiPowerCoefficient = 0.7
 	cellularPowerCoefficient = 2.5
-	energyData = copy.deepcopy(data)
+	energyData = {}
 	
 	mecData = []
 	confidenceValues = {}
@@ -220,7 +219,7 @@ if __name__ == "__main__":
 	os.makedirs(plotsPath, exist_ok=True)
 	os.makedirs(csvPath, exist_ok=True)
 	
-	data, keys = loadData(args.inputDir, "BatchExecution")
+	data, keys = loadData(args.inputDir, "BatchExecution", ["totalResponseTime:vector", "jobServiceTime:vector"])
 	setupPlots()
 	
 	responseData, respDataRaw = computeMeanResponseTime(data, keys, plotsPath)
@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+
+# Reader of the .cvec files written by ColumnarOutputVectorManager; the layout
+# is described in ColumnarVectorFormat.h. Only the blocks of the requested
+# vectors are touched, the rest of the memory-mapped file is never read.
+
+import argparse
+import fnmatch
+import mmap
+import struct
+import sys
+import zlib
+import numpy as np
+
+FILE_MAGIC = b"SDSCVEC\0"
+INDEX_MAGIC = b"SDSCVIDX"
+VERSION = 1
+FLOAT32 = 1
+DEFLATE = 2
+
+
+class Cursor:
+	def __init__(self, buffer, position=0):
+		self.buffer = buffer
+		self.position = position
+
+	def varint(self):
+		value = 0
+		shift = 0
+		while True:
+			byte = self.buffer[self.position]
+			self.position += 1
+			value |= (byte & 0x7f) << shift
+			if not byte & 0x80:
+				return value
+			shift += 7
+
+	def signedVarint(self):
+		value = self.varint()
+		return (value >> 1) ^ -(value & 1)
+
+	def fixed(self, fmt):
+		value, = struct.unpack_from("<" + fmt, self.buffer, self.position)
+		self.position += struct.calcsize(fmt)
+		return value
+
+	def string(self):
+		size = self.varint()
+		value = bytes(self.buffer[self.position:self.position + size]).decode("utf-8")
+		self.position += size
+		return value
+
+	def take(self, size):
+		value = self.buffer[self.position:self.position + size]
+		self.position += size
+		return value
+
+
+def decodeSignedVarints(column, count):
+	# vectorized LEB128: every byte is shifted by 7 * its position inside its
+	# varint, then the bytes of each varint are summed
+	data = np.frombuffer(column, dtype=np.uint8)
+	if count == 0:
+		return np.zeros(0, dtype=np.int64)
+	last = (data & 0x80) == 0
+	starts = np.flatnonzero(np.concatenate(([True], last[:-1])))
+	if starts.size != count:
+		raise ValueError("time column holds {} values, {} expected".format(starts.size, count))
+	position = np.arange(data.size) - np.repeat(starts, np.diff(np.append(starts, data.size)))
+	shifted = (data & 0x7f).astype(np.uint64) << (7 * position).astype(np.uint64)
+	values = np.add.reduceat(shifted, starts)
+	return (values >> np.uint64(1)).astype(np.int64) ^ -(values & np.uint64(1)).astype(np.int64)
+
+
+class ColumnarVectorFile:
+	def __init__(self, path):
+		self.path = path
+		self.file = open(path, "rb")
+		self.data = mmap.mmap(self.file.fileno(), 0, access=mmap.ACCESS_READ)
+		if self.data[:8] != FILE_MAGIC or struct.unpack_from("<I", self.data, 8)[0] != VERSION:
+			raise ValueError("{} is not a columnar vector file".format(path))
+		if self.data[-8:] != INDEX_MAGIC:
+			raise ValueError("{} has no index, the simulation did not finish".format(path))
+		self.readIndex(struct.unpack_from("<Q", self.data, len(self.data) - 16)[0])
+
+	def readIndex(self, offset):
+		index = Cursor(self.data, offset)
+		self.scale = 10.0 ** index.signedVarint()
+		self.runAttributes = {}
+		for _ in range(index.varint()):
+			key = index.string()
+			self.runAttributes[key] = index.string()
+
+		self.vectors = []
+		for _ in range(index.varint()):
+			vector = {"id": index.varint(), "module": index.string(), "name": index.string(), "attributes": {}}
+			for _ in range(index.varint()):
+				key = index.string()
+				vector["attributes"][key] = index.string()
+			vector["flags"] = index.fixed("B")
+			vector["samples"] = index.varint()
+			vector["min"] = index.fixed("d")
+			vector["max"] = index.fixed("d")
+			vector["sum"] = index.fixed("d")
+			vector["blocks"] = []
+			for _ in range(index.varint()):
+				vector["blocks"].append((index.varint(), index.varint(), index.signedVarint(), index.signedVarint()))
+			self.vectors.append(vector)
+
+	def close(self):
+		self.data.close()
+		self.file.close()
+
+	def __enter__(self):
+		return self
+
+	def __exit__(self, *args):
+		self.close()
+
+	def find(self, module="*", name="*"):
+		return [vector for vector in self.vectors if fnmatch.fnmatchcase(vector["module"], module) and fnmatch.fnmatchcase(vector["name"], name)]
+
+	def readBlock(self, offset):
+		block = Cursor(self.data, offset)
+		block.fixed("I")
+		samples = block.fixed("I")
+		flags = block.fixed("B")
+		timeBytes = block.fixed("I")
+		valueBytes = block.fixed("I")
+		if flags & DEFLATE:
+			block.fixed("I")
+			block.fixed("I")
+			timeColumn = zlib.decompress(block.take(timeBytes))
+			valueColumn = zlib.decompress(block.take(valueBytes))
+		else:
+			timeColumn = block.take(timeBytes)
+			valueColumn = block.take(valueBytes)
+		times = np.cumsum(decodeSignedVarints(timeColumn, samples))
+		values = np.frombuffer(valueColumn, dtype="<f4" if flags & FLOAT32 else "<f8").astype(np.float64)
+		return times, values
+
+	def read(self, vector, start=None, end=None):
+		# blocks entirely outside [start, end] (seconds) are skipped by the index
+		times = []
+		values = []
+		for offset, samples, firstTime, lastTime in vector["blocks"]:
+			if start is not None and lastTime * self.scale < start:
+				continue
+			if end is not None and firstTime * self.scale > end:
+				break
+			blockTimes, blockValues = self.readBlock(offset)
+			times.append(blockTimes)
+			values.append(blockValues)
+		if not times:
+			return np.zeros(0), np.zeros(0)
+		times = np.concatenate(times) * self.scale
+		values = np.concatenate(values)
+		mask = np.ones(times.size, dtype=bool)
+		if start is not None:
+			mask &= times >= start
+		if end is not None:
+			mask &= times <= end
+		return times[mask], values[mask]
+
+
+if __name__ == "__main__":
+	parser = argparse.ArgumentParser(description="Lists or exports the vectors of a .cvec file")
+	parser.add_argument("file", type=str)
+	parser.add_argument("--module", type=str, default="*")
+	parser.add_argument("--name", type=str, default="*")
+	parser.add_argument("--export", action="store_true", help="print the samples as CSV instead of the vector list")
+	args = parser.parse_args()
+
+	with ColumnarVectorFile(args.file) as vectors:
+		for vector in vectors.find(args.module, args.name):
+			if not args.export:
+				print("{}\t{}\t{}\t{}".format(vector["module"], vector["name"], vector["samples"], vector["sum"] / vector["samples"] if vector["samples"] else 0.0))
+				continue
+			times, values = vectors.read(vector)
+			for time, value in zip(times, values):
+				sys.stdout.write("{},{},{!r},{!r}\n".format(vector["module"], vector["name"], float(time), float(value)))
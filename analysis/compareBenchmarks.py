@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+
+import argparse
+import json
+import sys
+
+
+def loadBenchmarks(path):
+	# the last line of a (config, iterationvars) pair wins, so a file can be appended to
+	results = {}
+	with open(path, "r", encoding="utf-8") as input:
+		for line in input:
+			line = line.strip()
+			if not line:
+				continue
+			record = json.loads(line)
+			results[(record["config"], record["iterationvars"])] = record
+	return results
+
+
+def compareBenchmarks(baseline, current, threshold):
+	regressions = 0
+	print("{:<26} {:<60} {:>12} {:>12} {:>8} {:>10} {:>10}".format("Config", "Iteration", "Base ev/s", "Curr ev/s", "Change", "Base FES", "Curr FES"))
+	for key in sorted(current.keys()):
+		if key not in baseline:
+			continue
+		base = baseline[key]
+		curr = current[key]
+		change = curr["eventsPerSecond"] / base["eventsPerSecond"] - 1.0 if base["eventsPerSecond"] > 0 else 0.0
+		flags = []
+		if change < -threshold:
+			flags.append("SLOWER")
+		if curr["peakFesLength"] > base["peakFesLength"] * (1.0 + threshold):
+			flags.append("FES")
+		if base["peakRssKiB"] > 0 and curr["peakRssKiB"] > base["peakRssKiB"] * (1.0 + threshold):
+			flags.append("RSS")
+		# a different event count means the model changed, not only its speed
+		if curr["events"] != base["events"]:
+			flags.append("EVENTS")
+		if flags:
+			regressions += 1
+		print("{:<26} {:<60} {:>12.0f} {:>12.0f} {:>+7.1f}% {:>10} {:>10} {}".format(key[0], key[1], base["eventsPerSecond"], curr["eventsPerSecond"], change * 100.0, base["peakFesLength"], curr["peakFesLength"], " ".join(flags)))
+	return regressions
+
+
+if __name__ == "__main__":
+	parser = argparse.ArgumentParser(description="Compares two benchmark.jsonl files produced by 'make benchmark'")
+	parser.add_argument("--baseline", type=str, required=True)
+	parser.add_argument("--current", type=str, required=True)
+	parser.add_argument("--threshold", type=float, default=0.1, help="relative change reported as a regression")
+	args = parser.parse_args()
+
+	regressions = compareBenchmarks(loadBenchmarks(args.baseline), loadBenchmarks(args.current), args.threshold)
+	if regressions > 0:
+		print("{} benchmarks regressed by more than {:.0f}%".format(regressions, args.threshold * 100.0))
+		sys.exit(1)
@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+
+# Compares the ImportanceSampling runs with UntiltedSampling, the same
+# regenerative runs without the tilt: a method only pays off if its interval
+# is narrower for the same number of simulated jobs, so the efficiency is the
+# ratio of halfWidth^2 * jobs of the two runs (above 1, importance sampling
+# wins). The estimates should agree within their intervals.
+
+import argparse
+import os
+from utils import loadScalars
+
+SINK = "FullOffloadingNetwork.sink"
+METRICS = [("MRT", "MRT:weighted", "MRT:regenerative"), ("RenegingProbability", "renegingProbability:weighted", "renegingProbability:weighted")]
+
+
+def singleRun(data, renTime):
+	# one run per deadline
+	seedsData = data.get(renTime, {})
+	return next(iter(seedsData.values())) if seedsData else None
+
+
+def compare(tilted, untilted, csvPath):
+	rows = []
+	for renTime in sorted(set(tilted.keys()) & set(untilted.keys()), key=int):
+		tiltedScalars = singleRun(tilted, renTime)
+		untiltedScalars = singleRun(untilted, renTime)
+		for name, tiltedMetric, untiltedMetric in METRICS:
+			tiltedMean = tiltedScalars[(SINK, tiltedMetric + "Mean")]
+			tiltedHalfWidth = tiltedScalars[(SINK, tiltedMetric + "HalfWidth")]
+			untiltedMean = untiltedScalars[(SINK, untiltedMetric + "Mean")]
+			untiltedHalfWidth = untiltedScalars[(SINK, untiltedMetric + "HalfWidth")]
+			tiltedJobs = tiltedScalars[(SINK, "jobs")]
+			untiltedJobs = untiltedScalars[(SINK, "jobs")]
+			tiltedCost = tiltedHalfWidth ** 2 * tiltedJobs
+			efficiency = untiltedHalfWidth ** 2 * untiltedJobs / tiltedCost if tiltedCost > 0 else float("inf")
+			agree = abs(tiltedMean - untiltedMean) <= tiltedHalfWidth + untiltedHalfWidth
+			rows.append((int(renTime), name, tiltedMean, tiltedHalfWidth, int(tiltedJobs), untiltedMean, untiltedHalfWidth, int(untiltedJobs), efficiency, agree,
+				tiltedScalars.get((SINK, "likelihoodRatio:cycleMean"), float("nan"))))
+
+	print("{:>8} {:<20} {:>12} {:>10} {:>10} {:>12} {:>10} {:>10} {:>10} {:>6} {:>8}".format("Deadline", "Metric", "IS mean", "IS hw", "IS jobs", "Plain mean", "Plain hw", "Plain jobs", "Efficiency", "Agree", "Cycle LR"))
+	for row in rows:
+		print("{:>7}s {:<20} {:>12.6g} {:>10.3g} {:>10} {:>12.6g} {:>10.3g} {:>10} {:>10.2f} {:>6} {:>8.3f}".format(*row[:9], "yes" if row[9] else "NO", row[10]))
+
+	with open(os.path.join(csvPath, "ImportanceSamplingEfficiency.csv"), "w", encoding="utf-8") as csv:
+		print("Deadline [s], Metric, IS Mean, IS Half Width, IS Jobs, Untilted Mean, Untilted Half Width, Untilted Jobs, Efficiency, Agree, Mean Cycle Likelihood Ratio", file=csv)
+		for row in rows:
+			print("{}, {}, {:.6g}, {:.6g}, {}, {:.6g}, {:.6g}, {}, {:.4f}, {}, {:.4f}".format(*row[:9], int(row[9]), row[10]), file=csv)
+
+
+if __name__ == "__main__":
+	parser = argparse.ArgumentParser(description="Compares the confidence intervals per simulated job of ImportanceSampling and of the untilted runs")
+	parser.add_argument("--inputDir", type=str, required=True)
+	parser.add_argument("--outputDir", type=str, required=True)
+	parser.add_argument("--config", type=str, default="ImportanceSampling")
+	parser.add_argument("--baseline", type=str, default="UntiltedSampling")
+	args = parser.parse_args()
+	csvPath = os.path.join(args.outputDir, "csv")
+	os.makedirs(csvPath, exist_ok=True)
+
+	tilted, _ = loadScalars(args.inputDir, args.config)
+	untilted, _ = loadScalars(args.inputDir, args.baseline)
+	compare(tilted, untilted, csvPath)
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+
+# Runs PartitionedSequential and PartitionedExecution (one process per
+# partition, as launchSimulation.sh does) for the same repetitions, and
+# compares their wall-clock times and the sink scalars: the partitioned run
+# only pays off with a speedup, and it must give the same MRT, MEC and ERWP.
+
+import argparse
+import glob
+import os
+import subprocess
+import sys
+import time
+from runFarm import simulationCommand
+from utils import readScalarFile
+
+INI = "partitioned.ini"
+SINK = "PartitionedOffloadingNetwork.sink"
+METRICS = ["jobs", "MRT", "MEC", "ERWP_w_0.1", "ERWP_w_0.5", "ERWP_w_0.9"]
+
+
+def resultFiles(resultDir, config, run):
+	# the partitioned processes append their host and process id to the name
+	return glob.glob(os.path.join(resultDir, "{}-seed={}*.sca".format(config, run)))
+
+
+def sinkScalars(resultDir, config, run):
+	for path in resultFiles(resultDir, config, run):
+		scalars = {name: value for (module, name), value in readScalarFile(path).items() if module == SINK}
+		if scalars:
+			return scalars
+	raise Exception("No sink scalars of {} run {} in {}".format(config, run, resultDir))
+
+
+def timeRun(commands, logPaths):
+	start = time.monotonic()
+	processes = []
+	for command, logPath in zip(commands, logPaths):
+		log = open(logPath, "w", encoding="utf-8")
+		processes.append((subprocess.Popen(command, stdout=log, stderr=subprocess.STDOUT), log))
+	failed = False
+	for process, log in processes:
+		failed |= process.wait() != 0
+		log.close()
+	if failed:
+		raise Exception("A process failed, see {}".format(", ".join(logPaths)))
+	return time.monotonic() - start
+
+
+def comparePartitioned(args):
+	logDir = os.path.join(args.resultDir, "logs")
+	os.makedirs(logDir, exist_ok=True)
+	rows = []
+	for run in range(args.runs):
+		# stale files of an earlier partitioned run would be read instead
+		for config in ["PartitionedSequential", "PartitionedExecution"]:
+			for path in resultFiles(args.resultDir, config, run):
+				os.remove(path)
+
+		print("Run {}: sequential...".format(run))
+		sequentialTime = timeRun([simulationCommand("PartitionedSequential", iniFile=INI) + ["-r", str(run)]],
+			[os.path.join(logDir, "PartitionedSequential-{}.log".format(run))])
+		print("Run {}: {} partitions...".format(run, args.partitions))
+		commands = [simulationCommand("PartitionedExecution", iniFile=INI) + ["-r", str(run), "--parsim-procid={}".format(proc), "--parsim-num-partitions={}".format(args.partitions)] for proc in range(args.partitions)]
+		parallelTime = timeRun(commands, [os.path.join(logDir, "PartitionedExecution-{}-{}.log".format(run, proc)) for proc in range(args.partitions)])
+
+		sequential = sinkScalars(args.resultDir, "PartitionedSequential", run)
+		parallel = sinkScalars(args.resultDir, "PartitionedExecution", run)
+		values = []
+		agree = True
+		for name in METRICS:
+			sequentialValue = sequential.get(name, float("nan"))
+			parallelValue = parallel.get(name, float("nan"))
+			agree &= abs(sequentialValue - parallelValue) <= args.tolerance * abs(sequentialValue)
+			values += [sequentialValue, parallelValue]
+		rows.append((run, sequentialTime, parallelTime, sequentialTime / parallelTime, agree, values))
+
+	print("{:>4} {:>10} {:>10} {:>8} {:>6}  {}".format("Run", "Seq [s]", "Par [s]", "Speedup", "Agree", "  ".join("{:>23}".format(name + " seq/par") for name in METRICS)))
+	for run, sequentialTime, parallelTime, speedup, agree, values in rows:
+		pairs = ["{:>11.6g}/{:<11.6g}".format(values[2 * i], values[2 * i + 1]) for i in range(len(METRICS))]
+		print("{:>4} {:>10.1f} {:>10.1f} {:>8.2f} {:>6}  {}".format(run, sequentialTime, parallelTime, speedup, "yes" if agree else "NO", "  ".join(pairs)))
+
+	csvPath = os.path.join(args.outputDir, "csv")
+	os.makedirs(csvPath, exist_ok=True)
+	with open(os.path.join(csvPath, "PartitionedComparison.csv"), "w", encoding="utf-8") as csv:
+		header = ["Run", "Sequential Time [s]", "Partitioned Time [s]", "Speedup", "Agree"]
+		for name in METRICS:
+			header += ["{} Sequential".format(name), "{} Partitioned".format(name)]
+		print(", ".join(header), file=csv)
+		for run, sequentialTime, parallelTime, speedup, agree, values in rows:
+			print(", ".join([str(run), "{:.2f}".format(sequentialTime), "{:.2f}".format(parallelTime), "{:.3f}".format(speedup), str(int(agree))] + ["{:.10g}".format(v) for v in values]), file=csv)
+
+	return all(row[4] for row in rows)
+
+
+if __name__ == "__main__":
+	parser = argparse.ArgumentParser(description="Compares the wall-clock time and the sink scalars of PartitionedSequential and PartitionedExecution")
+	parser.add_argument("--runs", type=int, default=3, help="repetitions compared, from 0")
+	parser.add_argument("--partitions", type=int, default=4)
+	parser.add_argument("--resultDir", type=str, default="results")
+	parser.add_argument("--outputDir", type=str, default="analysis")
+	parser.add_argument("--tolerance", type=float, default=1e-9, help="relative difference allowed between the scalars")
+	args = parser.parse_args()
+
+	if not comparePartitioned(args):
+		print("The partitioned runs do not give the scalars of the sequential ones")
+		sys.exit(1)
@@ -9,18 +9,165 @@ fi
 nedPath=".:${QUEUEINGLIB}"
 libPath="${QUEUEINGLIB}/libqueueinglib.so"
 config=$1
+workers=$2
 
-if [ "$config" != "SetupAnalysis" ] && [ "$config" != "BatchExecution" ]
+if [ "$config" != "SetupAnalysis" ] && [ "$config" != "BatchExecution" ] && [ "$config" != "StreamingExecution" ] && [ "$config" != "ExponentialDeadline" ] && [ "$config" != "BatchMeans" ] && [ "$config" != "AutoWarmup" ] && [ "$config" != "MultiDeadline" ] && [ "$config" != "SnapshotExecution" ] && [ "$config" != "Regenerative" ] && [ "$config" != "ImportanceSampling" ] && [ "$config" != "MultiDeviceExecution" ] && [ "$config" != "PartitionedSequential" ] && [ "$config" != "PartitionedExecution" ] && [ "$config" != "PartitionedComparison" ] && [ "$config" != "TraceReplay" ]
 then
-	echo "Wrong configuration name. Use 'SetupAnalysis' or 'BatchExecution'. Exiting..."
+	echo "Wrong configuration name. Use 'SetupAnalysis', 'BatchExecution', 'StreamingExecution', 'ExponentialDeadline', 'BatchMeans', 'AutoWarmup', 'MultiDeadline', 'SnapshotExecution', 'Regenerative', 'ImportanceSampling', 'MultiDeviceExecution', 'PartitionedSequential', 'PartitionedExecution', 'PartitionedComparison' or 'TraceReplay'. Exiting..."
 	exit 2
 fi
 
+if [ "$config" == "MultiDeadline" ]
+then
+	# one run per seed with all the deadlines, so there is nothing to farm per deadline
+	echo "Launching ${config} configuration..."
+	if [ -n "$workers" ]
+	then
+		opp_runall -j$workers ./SdSFullOffloading -m -n $nedPath -l $libPath multiDeadline.ini -u Cmdenv -c $config || exit $?
+	else
+		./SdSFullOffloading -m -n $nedPath -l $libPath multiDeadline.ini -u Cmdenv -c $config
+	fi
+	echo "Computing simulation analysis..."
+	analysis/streamingAnalysis.py --inputDir results --outputDir analysis --config $config --pipelines
+	echo "DONE!"
+	exit 0
+fi
+
+if [ "$config" == "MultiDeviceExecution" ]
+then
+	# one run per device count and remote utilization, the sinks record the metrics as scalars
+	echo "Launching ${config} configuration..."
+	if [ -n "$workers" ]
+	then
+		opp_runall -j$workers ./SdSFullOffloading -m -n $nedPath -l $libPath multiDevice.ini -u Cmdenv -c $config || exit $?
+	else
+		./SdSFullOffloading -m -n $nedPath -l $libPath multiDevice.ini -u Cmdenv -c $config
+	fi
+	echo "DONE!"
+	exit 0
+fi
+
+if [ "$config" == "PartitionedSequential" ] || [ "$config" == "PartitionedExecution" ]
+then
+	echo "Launching ${config} configuration..."
+	if [ "$config" == "PartitionedSequential" ]
+	then
+		if [ -n "$workers" ]
+		then
+			opp_runall -j$workers ./SdSFullOffloading -m -n $nedPath -l $libPath partitioned.ini -u Cmdenv -c $config || exit $?
+		else
+			./SdSFullOffloading -m -n $nedPath -l $libPath partitioned.ini -u Cmdenv -c $config
+		fi
+	else
+		# one run at a time, with one process per partition (named pipes only work on the same host)
+		partitions=4
+		runs=$(./SdSFullOffloading -s -n $nedPath -l $libPath partitioned.ini -c $config -q numruns | tail -1)
+		for ((run = 0; run < runs; run++))
+		do
+			for ((proc = 0; proc < partitions; proc++))
+			do
+				./SdSFullOffloading -m -n $nedPath -l $libPath partitioned.ini -u Cmdenv -c $config -r $run --parsim-procid=$proc --parsim-num-partitions=$partitions &
+			done
+			wait
+		done
+	fi
+	echo "DONE!"
+	exit 0
+fi
+
+if [ "$config" == "PartitionedComparison" ]
+then
+	# both configurations for the same repetitions, timed, with their sink scalars compared
+	echo "Comparing PartitionedSequential and PartitionedExecution..."
+	analysis/comparePartitioned.py --runs ${workers:-3} --resultDir results --outputDir analysis || exit $?
+	echo "DONE!"
+	exit 0
+fi
+
+if [ "$config" == "SnapshotExecution" ]
+then
+	# one warmup per seed, every deadline starts from its snapshot
+	echo "Launching WarmupSnapshot configuration..."
+	if [ -n "$workers" ]
+	then
+		analysis/runFarm.py --config WarmupSnapshot --jobs $workers --noExport || exit $?
+	else
+		./SdSFullOffloading -m -n $nedPath -l $libPath omnetpp.ini -u Cmdenv -c WarmupSnapshot || exit $?
+	fi
+fi
+
+if [ "$config" == "ImportanceSampling" ]
+then
+	# the same runs without the tilt, the reference of the comparison
+	echo "Launching UntiltedSampling configuration..."
+	if [ -n "$workers" ]
+	then
+		analysis/runFarm.py --config UntiltedSampling --jobs $workers || exit $?
+	else
+		./SdSFullOffloading -m -n $nedPath -l $libPath omnetpp.ini -u Cmdenv -c UntiltedSampling || exit $?
+	fi
+fi
+
+if [ "$config" == "TraceReplay" ]
+then
+	# one trace per seed, replayed by every deadline
+	echo "Launching TraceRecord configuration..."
+	if [ -n "$workers" ]
+	then
+		analysis/runFarm.py --config TraceRecord --jobs $workers --noExport || exit $?
+	else
+		./SdSFullOffloading -m -n $nedPath -l $libPath omnetpp.ini -u Cmdenv -c TraceRecord || exit $?
+	fi
+fi
+
 echo "Launching ${config} configuration..."
-./SdSFullOffloading -m -n $nedPath -l $libPath omnetpp.ini -u Cmdenv -c $config
+if [ -n "$workers" ]
+then
+	# runs in parallel, resumes from results/${config}.ledger and exports every deadline as soon as it is complete
+	analysis/runFarm.py --config $config --jobs $workers || exit $?
+else
+	./SdSFullOffloading -m -n $nedPath -l $libPath omnetpp.ini -u Cmdenv -c $config
+fi
+
+if [ "$config" == "StreamingExecution" ] || [ "$config" == "ExponentialDeadline" ] || [ "$config" == "AutoWarmup" ] || [ "$config" == "SnapshotExecution" ] || [ "$config" == "TraceReplay" ]
+then
+	# metrics are already recorded as scalars, no export needed
+	echo "Computing simulation analysis..."
+	analysis/streamingAnalysis.py --inputDir results --outputDir analysis --config $config
+	echo "DONE!"
+	exit 0
+fi
+
+if [ "$config" == "BatchMeans" ]
+then
+	echo "Computing simulation analysis..."
+	analysis/streamingAnalysis.py --inputDir results --outputDir analysis --config BatchMeans --batchMeans
+	echo "DONE!"
+	exit 0
+fi
 
-echo "Exporting simulation data..."
-source analysis/exportStats.sh $config
+if [ "$config" == "Regenerative" ]
+then
+	echo "Computing simulation analysis..."
+	analysis/streamingAnalysis.py --inputDir results --outputDir analysis --config Regenerative --regenerative
+	echo "DONE!"
+	exit 0
+fi
+
+if [ "$config" == "ImportanceSampling" ]
+then
+	echo "Computing simulation analysis..."
+	analysis/streamingAnalysis.py --inputDir results --outputDir analysis --config ImportanceSampling --importanceSampling
+	analysis/compareImportanceSampling.py --inputDir results --outputDir analysis
+	echo "DONE!"
+	exit 0
+fi
+
+if [ -z "$workers" ]
+then
+	echo "Exporting simulation data..."
+	source analysis/exportStats.sh $config
+fi
 
 if [ "$config" == "SetupAnalysis" ]
 then
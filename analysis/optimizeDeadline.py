@@ -0,0 +1,317 @@
+#!/usr/bin/env python3
+
+import argparse
+import itertools
+import math
+import os
+import re
+import subprocess
+import sys
+import threading
+from concurrent.futures import ThreadPoolExecutor
+from runFarm import simulationCommand
+from utils import readScalarFile
+
+
+# cost of the grid of omnetpp.ini: 22 deadlines x 250 seeds
+GRID_PIPELINE_RUNS = 22 * 250
+
+
+class PipelineRunner:
+	"""
+	Runs a seed of the MultiDeadline configuration with an arbitrary set of
+	deadlines, one pipeline each. The pipelines share arrivals, service times
+	and WiFi periods, so the results of a deadline only depend on the seed and
+	on the deadline itself: the deadlines added later on are run on the old
+	seeds alone and still get the same common random numbers.
+	"""
+
+	def __init__(self, args):
+		self.args = args
+		self.workDir = os.path.join(args.resultDir, "optimize")
+		self.logDir = os.path.join(self.workDir, "logs")
+		os.makedirs(self.logDir, exist_ok=True)
+		self.counter = itertools.count()
+		self.lock = threading.Lock()
+		self.pipelineRuns = 0
+
+	def run(self, seed, deadlines):
+		index = next(self.counter)
+		name = "{}-seed={}-{}".format(self.args.config, seed, index)
+		scalarPath = os.path.join(self.workDir, name + ".sca")
+		command = simulationCommand(self.args.config, self.args.maxSeeds, self.args.iniFile) + ["-r", str(seed), "-s", "--*.numDeadlines={}".format(len(deadlines))]
+		command += ["--*.pipeline[{}].deadline={}s".format(i, deadline) for i, deadline in enumerate(deadlines)]
+		command += ["--output-scalar-file={}".format(scalarPath), "--output-vector-file={}".format(os.path.join(self.workDir, name + ".vec"))]
+
+		with open(os.path.join(self.logDir, name + ".log"), "w", encoding="utf-8") as log:
+			result = subprocess.run(command, stdout=log, stderr=subprocess.STDOUT)
+		if result.returncode != 0:
+			raise Exception("Seed {} failed with code {}, see {}".format(seed, result.returncode, self.logDir))
+
+		metrics = {}
+		for (module, scalar), value in readScalarFile(scalarPath).items():
+			match = re.search(r"pipeline\[(\d+)\]\.sink$", module)
+			if match and scalar in ("MRT", "MEC"):
+				metrics.setdefault(deadlines[int(match.group(1))], {})[scalar] = value
+		if not self.args.keep:
+			os.remove(scalarPath)
+		for deadline in deadlines:
+			if "MRT" not in metrics.get(deadline, {}) or "MEC" not in metrics.get(deadline, {}):
+				raise Exception("Seed {} did not record MRT and MEC for deadline {}s; the configuration needs streamingStatistics".format(seed, deadline))
+
+		with self.lock:
+			self.pipelineRuns += len(deadlines)
+		return seed, metrics
+
+	def runAll(self, tasks):
+		"""Runs (seed, deadlines) pairs on parallel workers, yields their results."""
+		with ThreadPoolExecutor(max_workers=self.args.jobs) as pool:
+			for future in [pool.submit(self.run, seed, deadlines) for seed, deadlines in tasks if deadlines]:
+				yield future.result()
+
+
+class Candidate:
+
+	def __init__(self, deadline):
+		self.deadline = deadline
+		self.mrt = {}
+		self.mec = {}
+		self.status = "active"
+
+	def seeds(self):
+		return set(self.mrt.keys())
+
+
+class DeadlineOptimizer:
+	"""
+	Sequential ranking and selection over the deadlines, with common random
+	numbers. Every stage screens the active deadlines against the current best
+	with paired t tests on the shared seeds, adds the midpoints between the best
+	and its nearest evaluated neighbours, and gives new seeds to the surviving
+	deadlines only, so the replications pile up near the optimum.
+
+	The tests of all the stages share the error rate alpha (Bonferroni), so
+	with probability at least 1 - alpha the best of the evaluated deadlines is
+	among the ones left (every elimination was against a deadline that may
+	itself be eliminated later, so nothing stronger holds for the one
+	reported).
+	"""
+
+	def __init__(self, args, runner):
+		self.args = args
+		self.runner = runner
+		self.candidates = {}
+		self.seeds = []
+		self.nextSeed = 0
+		self.stage = 0
+
+	def objective(self, candidate, seed):
+		if self.args.energyBudget is not None:
+			return candidate.mrt[seed]
+		w = self.args.weight
+		return candidate.mec[seed] ** w * candidate.mrt[seed] ** (1 - w)
+
+	def objectiveName(self):
+		return "MRT" if self.args.energyBudget is not None else "ERWP_w_{}".format(self.args.weight)
+
+	def active(self):
+		return sorted((c for c in self.candidates.values() if c.status == "active"), key=lambda c: c.deadline)
+
+	def addSeeds(self, count):
+		newSeeds = list(range(self.nextSeed, min(self.nextSeed + count, self.args.maxSeeds)))
+		self.nextSeed += len(newSeeds)
+		self.seeds += newSeeds
+		deadlines = [c.deadline for c in self.active()]
+		self.collect((seed, deadlines) for seed in newSeeds)
+		return len(newSeeds)
+
+	def addCandidates(self, deadlines):
+		# the new deadlines catch up on the seeds run so far
+		for deadline in deadlines:
+			self.candidates[deadline] = Candidate(deadline)
+		self.collect((seed, deadlines) for seed in self.seeds)
+
+	def collect(self, tasks):
+		for seed, metrics in self.runner.runAll(list(tasks)):
+			for deadline, values in metrics.items():
+				self.candidates[deadline].mrt[seed] = values["MRT"]
+				self.candidates[deadline].mec[seed] = values["MEC"]
+
+	def best(self):
+		active = self.active()
+		if self.args.energyBudget is not None:
+			feasible = [c for c in active if mean(c.mec.values()) <= self.args.energyBudget]
+			if not feasible:
+				return min(active, key=lambda c: mean(c.mec.values()))
+			active = feasible
+		return min(active, key=lambda c: mean(self.objective(c, s) for s in c.seeds()))
+
+	def stageAlpha(self, tests):
+		return self.args.alpha / (self.args.maxStages * max(tests, 1))
+
+	def screen(self):
+		import scipy.stats as stats
+		budget = self.args.energyBudget is not None
+		active = self.active()
+		alpha = self.stageAlpha((len(active) - 1) * (2 if budget else 1) + (1 if budget else 0))
+		if budget:
+			over = [c for c in self.active() if len(c.mec) > 1 and lowerBound(list(c.mec.values()), stats.t.ppf(1 - alpha, len(c.mec) - 1)) > self.args.energyBudget]
+			if len(over) == len(self.active()):
+				# nothing meets the budget: keep the least consuming deadline
+				over.remove(min(over, key=lambda c: mean(c.mec.values())))
+			for candidate in over:
+				candidate.status = "over budget"
+		best = self.best()
+		for candidate in self.active():
+			if candidate is best:
+				continue
+			common = sorted(candidate.seeds() & best.seeds())
+			if len(common) < 2:
+				continue
+			differences = [self.objective(candidate, s) - self.objective(best, s) for s in common]
+			if lowerBound(differences, stats.t.ppf(1 - alpha, len(common) - 1)) > 0:
+				candidate.status = "worse"
+		return best
+
+	def neighbours(self, best):
+		evaluated = sorted(self.candidates.keys())
+		i = evaluated.index(best.deadline)
+		return (evaluated[i - 1] if i > 0 else None), (evaluated[i + 1] if i + 1 < len(evaluated) else None)
+
+	def refinements(self, best):
+		deadlines = []
+		for neighbour in self.neighbours(best):
+			if neighbour is None or abs(best.deadline - neighbour) <= self.args.resolution:
+				continue
+			midpoint = int(round((best.deadline + neighbour) / 2))
+			if midpoint not in self.candidates:
+				deadlines.append(midpoint)
+		return deadlines
+
+	def withinIndifference(self, best):
+		bestMean = mean(self.objective(best, s) for s in best.seeds())
+		for candidate in self.active():
+			if mean(self.objective(candidate, s) for s in candidate.seeds()) - bestMean > self.args.indifference * bestMean:
+				return False
+		return True
+
+	def optimize(self):
+		ratio = (self.args.maxDeadline / self.args.minDeadline) ** (1 / max(self.args.initialPoints - 1, 1))
+		grid = sorted({int(round(self.args.minDeadline * ratio ** i)) for i in range(self.args.initialPoints)})
+		for deadline in grid:
+			self.candidates[deadline] = Candidate(deadline)
+		print("Stage 0: {} deadlines, {} seeds".format(len(grid), self.args.initialReps))
+		self.addSeeds(self.args.initialReps)
+
+		while True:
+			self.stage += 1
+			best = self.screen()
+			active = self.active()
+			print("Stage {}: best {}s, {} active of {} deadlines, {} seeds, {} pipeline runs".format(
+				self.stage, best.deadline, len(active), len(self.candidates), len(best.seeds()), self.runner.pipelineRuns))
+
+			refinements = self.refinements(best)
+			if not refinements and (len(active) == 1 or self.withinIndifference(best)):
+				return best, "converged"
+			if self.stage >= self.args.maxStages:
+				return best, "stage limit"
+			if refinements:
+				print("  adding {}".format(", ".join("{}s".format(d) for d in refinements)))
+				self.addCandidates(refinements)
+			if self.addSeeds(self.args.stageReps) == 0 and not refinements:
+				return best, "seed limit"
+
+	def interval(self, values):
+		import scipy.stats as stats
+		values = list(values)
+		n = len(values)
+		if n < 2:
+			return mean(values), float("inf")
+		return mean(values), stats.t.ppf(1 - self.args.alpha / 2, n - 1) * stdev(values) / math.sqrt(n)
+
+	def writeReport(self, best, reason):
+		name = self.objectiveName()
+		objective, objectiveWidth = self.interval(self.objective(best, s) for s in best.seeds())
+		mrt, mrtWidth = self.interval(best.mrt.values())
+		mec, mecWidth = self.interval(best.mec.values())
+		left, right = self.neighbours(best)
+		active = self.active()
+		confidence = 100 * (1 - self.args.alpha)
+
+		print("\nOptimal deadline: {}s ({} after {} stages)".format(best.deadline, reason, self.stage))
+		intervals = "MRT = {:.4f} +- {:.4f}, MEC = {:.4f} +- {:.4f}".format(mrt, mrtWidth, mec, mecWidth)
+		if self.args.energyBudget is None:
+			intervals = "{} = {:.4f} +- {:.4f}, ".format(name, objective, objectiveWidth) + intervals
+		print("  {} ({:g}% CI, {} seeds)".format(intervals, confidence, len(best.seeds())))
+		if len(active) > 1:
+			print("  With {:g}% confidence the best evaluated deadline is among the {} left, {}".format(
+				confidence, len(active), ", ".join("{}s".format(c.deadline) for c in active)), end="")
+			if self.withinIndifference(best):
+				print(", which are within {:g}% of the {} of {}s".format(100 * self.args.indifference, name, best.deadline), end="")
+			print(".")
+		else:
+			print("  With {:g}% confidence {}s is the best evaluated deadline, the only one left.".format(confidence, best.deadline))
+		if self.args.energyBudget is not None and mec > self.args.energyBudget:
+			print("  No deadline met the energy budget of {}; this is the one with the lowest MEC".format(self.args.energyBudget))
+		elif left is not None or right is not None:
+			print("  If {} is unimodal in the deadline, the optimum lies between {}s and {}s".format(
+				name, left if left is not None else best.deadline, right if right is not None else best.deadline))
+		print("  Cost: {} pipeline runs, {:.1f}% of the {} of the full grid".format(
+			self.runner.pipelineRuns, 100 * self.runner.pipelineRuns / GRID_PIPELINE_RUNS, GRID_PIPELINE_RUNS))
+
+		path = os.path.join(self.args.resultDir, "optimize-{}.csv".format(name))
+		with open(path, "w", encoding="utf-8") as csv:
+			print(", ".join(["Deadline [s]", "Seeds", "{} Mean".format(name), "{} Half Width".format(name), "MRT Mean", "MEC Mean", "Status"]), file=csv)
+			for candidate in sorted(self.candidates.values(), key=lambda c: c.deadline):
+				value, width = self.interval(self.objective(candidate, s) for s in candidate.seeds())
+				status = "best" if candidate is best else candidate.status
+				print("{}, {}, {:.4f}, {:.4f}, {:.4f}, {:.4f}, {}".format(candidate.deadline, len(candidate.seeds()), value, width,
+					mean(candidate.mrt.values()), mean(candidate.mec.values()), status), file=csv)
+		print("Candidates written to {}".format(path))
+
+
+def mean(values):
+	values = list(values)
+	return sum(values) / len(values)
+
+
+def stdev(values):
+	m = mean(values)
+	return math.sqrt(sum((v - m) ** 2 for v in values) / (len(values) - 1))
+
+
+def lowerBound(values, quantile):
+	return mean(values) - quantile * stdev(values) / math.sqrt(len(values))
+
+
+if __name__ == "__main__":
+	parser = argparse.ArgumentParser(description="Searches the deadline that minimizes ERWP, or MRT under an energy budget, with ranking and selection on common random numbers")
+	parser.add_argument("--weight", type=float, default=0.5, help="ERWP exponent w of MEC")
+	parser.add_argument("--energyBudget", type=float, help="minimize MRT among the deadlines with mean MEC within this budget, instead of ERWP")
+	parser.add_argument("--minDeadline", type=int, default=1200)
+	parser.add_argument("--maxDeadline", type=int, default=9000)
+	parser.add_argument("--initialPoints", type=int, default=6, help="deadlines of the first stage, geometrically spaced")
+	parser.add_argument("--initialReps", type=int, default=10, help="seeds of the first stage")
+	parser.add_argument("--stageReps", type=int, default=10, help="seeds added to the active deadlines at every stage")
+	parser.add_argument("--resolution", type=int, default=60, help="deadlines closer than this, in seconds, are not refined further")
+	parser.add_argument("--indifference", type=float, default=0.01, help="relative difference of the objective below which deadlines are equivalent")
+	parser.add_argument("--alpha", type=float, default=0.1, help="overall error rate of the eliminations")
+	parser.add_argument("--maxStages", type=int, default=20)
+	parser.add_argument("--maxSeeds", type=int, default=250)
+	parser.add_argument("--jobs", type=int, default=os.cpu_count())
+	parser.add_argument("--config", type=str, default="MultiDeadline")
+	parser.add_argument("--iniFile", type=str, default="multiDeadline.ini")
+	parser.add_argument("--resultDir", type=str, default="results")
+	parser.add_argument("--keep", action="store_true", help="keep the scalar files of the runs")
+	args = parser.parse_args()
+
+	if not 0 <= args.weight <= 1 or args.minDeadline >= args.maxDeadline or args.initialReps < 2:
+		parser.error("the weight must be in [0, 1], minDeadline below maxDeadline and initialReps at least 2")
+
+	optimizer = DeadlineOptimizer(args, PipelineRunner(args))
+	try:
+		best, reason = optimizer.optimize()
+	except Exception as e:
+		print(e)
+		sys.exit(1)
+	optimizer.writeReport(best, reason)
@@ -0,0 +1,334 @@
+#!/usr/bin/env python3
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+from concurrent.futures import ThreadPoolExecutor, wait, FIRST_COMPLETED
+from utils import readScalarFile
+
+
+class RunLedger:
+	"""Append-only record of finished runs, used to resume an interrupted sweep."""
+
+	def __init__(self, path):
+		self.path = path
+		self.done = set()
+		self.exported = set()
+		self.stopped = set()
+		if os.path.exists(path):
+			with open(path, "r", encoding="utf-8") as ledger:
+				for line in ledger:
+					fields = line.split()
+					if len(fields) < 2:
+						continue
+					if fields[0] == "done":
+						self.done.add(int(fields[1]))
+					elif fields[0] == "exported":
+						self.exported.add(fields[1])
+					elif fields[0] == "stopped":
+						self.stopped.add(fields[1])
+
+	def append(self, *fields):
+		with open(self.path, "a", encoding="utf-8") as ledger:
+			print(" ".join(str(f) for f in fields), file=ledger)
+			ledger.flush()
+			os.fsync(ledger.fileno())
+
+	def markDone(self, runNumber, renegingTime):
+		self.done.add(runNumber)
+		self.append("done", runNumber, renegingTime)
+
+	def markFailed(self, runNumber, renegingTime, returnCode):
+		self.append("failed", runNumber, renegingTime, returnCode)
+
+	def markExported(self, renegingTime):
+		self.exported.add(renegingTime)
+		self.append("exported", renegingTime)
+
+	def markStopped(self, renegingTime, replications):
+		self.stopped.add(renegingTime)
+		self.append("stopped", renegingTime, replications)
+
+
+def simulationCommand(config, repeat=None, iniFile="omnetpp.ini"):
+	queueinglib = os.environ.get("QUEUEINGLIB")
+	if not queueinglib:
+		print("$QUEUEINGLIB variable not set. Exiting...")
+		sys.exit(1)
+	nedPath = ".:{}".format(queueinglib)
+	libPath = os.path.join(queueinglib, "libqueueinglib.so")
+	command = ["./SdSFullOffloading", "-m", "-n", nedPath, "-l", libPath, iniFile, "-u", "Cmdenv", "-c", config]
+	if repeat:
+		command.append("--repeat={}".format(repeat))
+	return command
+
+
+def enumerateRuns(config, repeat=None):
+	output = subprocess.run(simulationCommand(config, repeat) + ["-q", "runs"], stdout=subprocess.PIPE, universal_newlines=True, check=True).stdout
+	runs = []
+	for line in output.splitlines():
+		match = re.match(r"\s*Run (\d+): (.*)", line)
+		if not match:
+			continue
+		renTime = re.search(r"\$renegingTime=([0-9]+)", match.group(2))
+		repetition = re.search(r"\$repetition=([0-9]+)", match.group(2))
+		runs.append({
+			"run": int(match.group(1)),
+			"renegingTime": renTime.group(1) if renTime else "none",
+			"repetition": int(repetition.group(1)) if repetition else 0
+		})
+	return sorted(runs, key=lambda r: r["run"])
+
+
+def executeRun(config, run, logDir, repeat=None):
+	logPath = os.path.join(logDir, "{}-{}.log".format(config, run["run"]))
+	with open(logPath, "w", encoding="utf-8") as log:
+		result = subprocess.run(simulationCommand(config, repeat) + ["-r", str(run["run"]), "-s"], stdout=log, stderr=subprocess.STDOUT)
+	return result.returncode
+
+
+def exportDeadline(config, renegingTime, resultDir):
+	# same conversion as exportStats.sh, restricted to the files of one deadline
+	jsonDir = os.path.join(resultDir, "JSON")
+	os.makedirs(jsonDir, exist_ok=True)
+	suffix = "renegingTime={}.vec".format(renegingTime)
+	for file in sorted(os.listdir(resultDir)):
+		if file.startswith(config) and file.endswith(suffix):
+			out = os.path.join(jsonDir, file[:-len(".vec")] + ".json")
+			subprocess.run(["scavetool", "x", "-f", 'module("*")', "-o", out, "-F", "JSON", os.path.join(resultDir, file)], check=True)
+
+
+def exportFinished(future, renegingTime, ledger):
+	# the exception of a failed scavetool call (exit code or missing binary) is
+	# raised again here, on the main thread, so that the farm does not report
+	# success with deadlines missing from the export
+	try:
+		future.result()
+	except (subprocess.CalledProcessError, OSError) as e:
+		print("Export of renegingTime={} failed: {}".format(renegingTime, e))
+		return False
+	ledger.markExported(renegingTime)
+	return True
+
+
+class DeadlineScheduler:
+	"""Hands out runs deadline by deadline, in run number order."""
+
+	def __init__(self, runs, ledger):
+		self.pending = {}
+		self.remaining = {}
+		for run in runs:
+			renTime = run["renegingTime"]
+			self.remaining.setdefault(renTime, 0)
+			if run["run"] not in ledger.done:
+				self.pending.setdefault(renTime, []).append(run)
+				self.remaining[renTime] += 1
+		self.order = [renTime for renTime in self.remaining.keys() if renTime in self.pending]
+
+	def nextRun(self):
+		for renTime in self.order:
+			if self.pending.get(renTime):
+				return self.pending[renTime].pop(0)
+		return None
+
+	def runFinished(self, run, succeeded):
+		if succeeded:
+			self.remaining[run["renegingTime"]] -= 1
+
+	def isDeadlineComplete(self, renTime):
+		return self.remaining[renTime] == 0
+
+
+class AdaptiveScheduler(DeadlineScheduler):
+	"""
+	Sequential stopping: hands out runs round-robin over the deadlines and
+	stops scheduling new seeds for a deadline once the 90% confidence
+	intervals of all its metrics are within the requested relative precision.
+	"""
+
+	def __init__(self, runs, ledger, args):
+		super().__init__(runs, ledger)
+		self.args = args
+		self.ledger = ledger
+		self.values = {renTime: {} for renTime in self.remaining.keys()}
+		self.next = 0
+		# results of runs completed before an interruption
+		for run in runs:
+			if run["run"] in ledger.done:
+				self.collect(run)
+		for renTime in ledger.stopped:
+			self.stop(renTime)
+
+	def nextRun(self):
+		active = [renTime for renTime in self.order if self.pending.get(renTime)]
+		if not active:
+			return None
+		renTime = active[self.next % len(active)]
+		self.next += 1
+		return self.pending[renTime].pop(0)
+
+	def collect(self, run):
+		scalars = readRunScalars(self.args.config, run, self.args.resultDir)
+		for name in self.args.metrics:
+			if name not in scalars:
+				raise Exception("Scalar {} not recorded by run {}; use a configuration with streamingStatistics enabled".format(name, run["run"]))
+			self.values[run["renegingTime"]].setdefault(name, []).append(scalars[name])
+
+	def intervals(self, renTime):
+		import scipy.stats as stats
+		result = {}
+		for name, values in self.values[renTime].items():
+			n = len(values)
+			mean = sum(values) / n
+			if n < 2:
+				result[name] = (mean, float("inf"))
+				continue
+			variance = sum((v - mean) ** 2 for v in values) / (n - 1)
+			halfWidth = stats.t.ppf(0.95, n - 1) * (variance / n) ** 0.5
+			result[name] = (mean, halfWidth)
+		return result
+
+	def isPreciseEnough(self, renTime):
+		replications = len(self.values[renTime].get(self.args.metrics[0], []))
+		if replications < self.args.minReps:
+			return False
+		for mean, halfWidth in self.intervals(renTime).values():
+			if halfWidth > self.args.precision * abs(mean):
+				return False
+		return True
+
+	def stop(self, renTime):
+		# dropped runs are not needed any more
+		self.remaining[renTime] -= len(self.pending.get(renTime, []))
+		self.pending[renTime] = []
+
+	def runFinished(self, run, succeeded):
+		super().runFinished(run, succeeded)
+		if not succeeded:
+			return
+		renTime = run["renegingTime"]
+		self.collect(run)
+		if renTime not in self.ledger.stopped and self.isPreciseEnough(renTime):
+			replications = len(self.values[renTime][self.args.metrics[0]])
+			print("renegingTime={} reached the requested precision after {} runs".format(renTime, replications))
+			self.ledger.markStopped(renTime, replications)
+			self.stop(renTime)
+
+	def writeReport(self, path):
+		with open(path, "w", encoding="utf-8") as csv:
+			header = ["Deadline [s]", "Runs"]
+			for name in self.args.metrics:
+				header += ["{} Mean".format(name), "{} Half Width".format(name)]
+			print(", ".join(header), file=csv)
+			for renTime in sorted(self.values.keys(), key=int):
+				intervals = self.intervals(renTime)
+				row = [renTime, str(len(self.values[renTime].get(self.args.metrics[0], [])))]
+				for name in self.args.metrics:
+					mean, halfWidth = intervals[name]
+					row += ["{:.4f}".format(mean), "{:.4f}".format(halfWidth)]
+				print(", ".join(row), file=csv)
+
+
+def readRunScalars(config, run, resultDir):
+	path = os.path.join(resultDir, "{}-seed={},renegingTime={}.sca".format(config, run["repetition"], run["renegingTime"]))
+	return {name: value for (module, name), value in readScalarFile(path).items() if module.endswith(".sink")}
+
+
+def runFarm(args):
+	os.makedirs(args.resultDir, exist_ok=True)
+	logDir = os.path.join(args.resultDir, "logs")
+	os.makedirs(logDir, exist_ok=True)
+
+	ledger = RunLedger(os.path.join(args.resultDir, "{}.ledger".format(args.config)))
+	runs = enumerateRuns(args.config, args.maxReps)
+	if args.precision:
+		scheduler = AdaptiveScheduler(runs, ledger, args)
+	else:
+		scheduler = DeadlineScheduler(runs, ledger)
+	todo = sum(1 for run in runs if run["run"] not in ledger.done)
+	print("{} runs in {}, {} already done, {} workers".format(len(runs), args.config, len(runs) - todo, args.jobs))
+
+	exportNeeded = args.config not in ["StreamingExecution", "ExponentialDeadline", "BatchMeans", "AutoWarmup", "SnapshotExecution", "Regenerative", "ImportanceSampling", "UntiltedSampling", "TraceRecord", "TraceReplay"] and not args.noExport
+	failures = 0
+	exportFailures = 0
+	finished = 0
+	if exportNeeded:
+		# deadlines completed by a previous, interrupted invocation
+		for renTime in scheduler.remaining.keys():
+			if scheduler.isDeadlineComplete(renTime) and renTime not in ledger.exported:
+				try:
+					exportDeadline(args.config, renTime, args.resultDir)
+					ledger.markExported(renTime)
+				except (subprocess.CalledProcessError, OSError) as e:
+					print("Export of renegingTime={} failed: {}".format(renTime, e))
+					exportFailures += 1
+
+	# exports run on their own thread so that workers keep being fed meanwhile
+	with ThreadPoolExecutor(max_workers=1) as exporter, ThreadPoolExecutor(max_workers=args.jobs) as pool:
+		inFlight = {}
+		exports = {}
+		while True:
+			while len(inFlight) < args.jobs:
+				run = scheduler.nextRun()
+				if run is None:
+					break
+				inFlight[pool.submit(executeRun, args.config, run, logDir, args.maxReps)] = run
+			if not inFlight:
+				break
+
+			done, _ = wait(inFlight.keys(), return_when=FIRST_COMPLETED)
+			for future in done:
+				run = inFlight.pop(future)
+				returnCode = future.result()
+				renTime = run["renegingTime"]
+				finished += 1
+				if returnCode == 0:
+					ledger.markDone(run["run"], renTime)
+				else:
+					failures += 1
+					ledger.markFailed(run["run"], renTime, returnCode)
+					print("Run {} failed with code {}, see {}".format(run["run"], returnCode, logDir))
+				scheduler.runFinished(run, returnCode == 0)
+				print("Finished run {} ({} of at most {})".format(run["run"], finished, todo))
+
+				if scheduler.isDeadlineComplete(renTime) and exportNeeded and renTime not in ledger.exported:
+					print("All runs for renegingTime={} done, exporting...".format(renTime))
+					exports[exporter.submit(exportDeadline, args.config, renTime, args.resultDir)] = renTime
+
+			for future in [future for future in exports if future.done()]:
+				if not exportFinished(future, exports.pop(future), ledger):
+					exportFailures += 1
+
+		for future, renTime in exports.items():
+			if not exportFinished(future, renTime, ledger):
+				exportFailures += 1
+
+	if args.precision:
+		reportPath = os.path.join(args.resultDir, "{}-replications.csv".format(args.config))
+		scheduler.writeReport(reportPath)
+		print("Replications per deadline written to {}".format(reportPath))
+
+	return failures, exportFailures
+
+
+if __name__ == "__main__":
+	parser = argparse.ArgumentParser(description="Runs all the runs of a configuration on parallel worker processes")
+	parser.add_argument("--config", type=str, required=True)
+	parser.add_argument("--jobs", type=int, default=os.cpu_count())
+	parser.add_argument("--resultDir", type=str, default="results")
+	parser.add_argument("--noExport", action="store_true", help="do not export vectors to JSON")
+	parser.add_argument("--precision", type=float, help="stop a deadline once every 90%% CI half width is within this fraction of its mean")
+	parser.add_argument("--minReps", type=int, default=10, help="replications always executed per deadline with --precision")
+	parser.add_argument("--maxReps", type=int, help="replications available per deadline (overrides 'repeat' of the configuration)")
+	parser.add_argument("--metrics", type=str, nargs="+", default=["MRT", "MEC", "ERWP_w_0.1", "ERWP_w_0.5", "ERWP_w_0.9"], help="sink scalars checked with --precision")
+	args = parser.parse_args()
+
+	failures, exportFailures = runFarm(args)
+	if failures > 0:
+		print("{} runs failed; launch again to retry them".format(failures))
+		sys.exit(3)
+	if exportFailures > 0:
+		print("{} deadlines were not exported; launch again to retry them".format(exportFailures))
+		sys.exit(4)
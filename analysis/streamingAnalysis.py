@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+
+import argparse
+import numpy as np
+import os
+from utils import loadScalars, loadPipelineScalars, filterScalar, setupPlots, plotGraph
+from analysis import computeERWP, computeBatchMetrics, writeBatchMetrics
+
+
+def meanPerDeadline(perSeedData):
+	return {renTime: np.mean(list(seedsData.values())) for renTime, seedsData in perSeedData.items() if len(seedsData) > 0}
+
+
+def singleRunIntervals(data, name, method="batch"):
+	# one run per deadline: the sink already computed the interval from its batches or regeneration cycles
+	dataToWrite = {}
+	for renTime, seedsData in data.items():
+		for scalars in seedsData.values():
+			mean = scalars[("FullOffloadingNetwork.sink", "{}:{}Mean".format(name, method))]
+			halfWidth = scalars[("FullOffloadingNetwork.sink", "{}:{}HalfWidth".format(name, method))]
+			dataToWrite.setdefault("total", {})[int(renTime)] = {
+				"mean": mean,
+				"variance": scalars[("FullOffloadingNetwork.sink", "{}:{}Variance".format(name, method))],
+				"minVal": mean - halfWidth,
+				"maxVal": mean + halfWidth
+			}
+	return dataToWrite
+
+
+def plotMetricTrend(means, degree, titles, filePath):
+	points = np.array([[int(renTime) / 60.0, mean] for renTime, mean in means.items()])
+	points = points[points[:,0].argsort()]
+	xs = points[:,0]
+	ys = points[:,1]
+	p = np.poly1d(np.polyfit(xs, ys, degree))
+	plotGraph([xs.tolist()], [p(xs).tolist()], titles, legends=["trend"], savePath=filePath)
+
+
+if __name__ == "__main__":
+	parser = argparse.ArgumentParser()
+	parser.add_argument("--inputDir", type=str, required=True)
+	parser.add_argument("--outputDir", type=str, required=True)
+	parser.add_argument("--config", type=str, default="StreamingExecution")
+	parser.add_argument("--w", type=float, nargs="+", default=[0.1, 0.5, 0.9])
+	parser.add_argument("--batchMeans", action="store_true", help="intervals come from the batches of a single run per deadline")
+	parser.add_argument("--regenerative", action="store_true", help="intervals come from the regeneration cycles of a single run per deadline")
+	parser.add_argument("--importanceSampling", action="store_true", help="only the weighted MRT and reneging probability of importance sampling runs are valid")
+	parser.add_argument("--pipelines", action="store_true", help="every run has all the deadlines (MultiDeadlineNetwork)")
+	args = parser.parse_args()
+	plotsPath = os.path.join(args.outputDir, "plots")
+	csvPath = os.path.join(args.outputDir, "csv")
+	os.makedirs(plotsPath, exist_ok=True)
+	os.makedirs(csvPath, exist_ok=True)
+
+	# MRT, MEC and ERWP were already computed by the sink for every run
+	if args.pipelines:
+		data, keys = loadPipelineScalars(args.inputDir, args.config)
+	else:
+		data, keys = loadScalars(args.inputDir, args.config)
+	if args.importanceSampling:
+		# the plain scalars describe the tilted system, MEC and ERWP are not estimated
+		print("Writing importance sampling confidence intervals...")
+		writeBatchMetrics(singleRunIntervals(data, "MRT", "weighted"), "MRT_IS", csvPath)
+		writeBatchMetrics(singleRunIntervals(data, "renegingProbability", "weighted"), "RenegingProbability", csvPath)
+		exit(0)
+
+	setupPlots()
+
+	mrtData = filterScalar(data, "MRT")
+	mecData = filterScalar(data, "MEC")
+
+	print("Plotting Mean Response Time...")
+	titles = {"title": "Full Offloading Model", "x": "Deadline [min]", "y": "Mean Response Time [min]"}
+	plotMetricTrend(meanPerDeadline(mrtData), 7, titles, os.path.join(plotsPath, "FullOffloading_Response_Deadline.png"))
+
+	print("Plotting Mean Energy Consumption... ")
+	titles = {"title": "Full Offloading Model", "x": "Deadline [min]", "y": "Mean Energy Consumption [J]"}
+	plotMetricTrend(meanPerDeadline(mecData), 5, titles, os.path.join(plotsPath, "FullOffloading_Energy_Deadline.png"))
+
+	computeERWP(meanPerDeadline(mrtData), meanPerDeadline(mecData), keys, plotsPath, w=args.w)
+
+	if args.batchMeans or args.regenerative:
+		method = "batch" if args.batchMeans else "regenerative"
+		print("Writing {} confidence intervals...".format("batch means" if args.batchMeans else "regenerative"))
+		writeBatchMetrics(singleRunIntervals(data, "MRT", method), "MRT", csvPath)
+		writeBatchMetrics(singleRunIntervals(data, "MEC", method), "MEC", csvPath)
+		for exp in args.w:
+			writeBatchMetrics(singleRunIntervals(data, "ERWP_w_{}".format(exp), method), "ERWP", csvPath, "w_{}".format(exp))
+	else:
+		writeBatchMetrics(computeBatchMetrics(mrtData), "MRT", csvPath)
+		writeBatchMetrics(computeBatchMetrics(mecData, metric="MEC"), "MEC", csvPath)
+
+		for exp in args.w:
+			erwpData = filterScalar(data, "ERWP_w_{}".format(exp))
+			erwpIntervals = computeBatchMetrics(erwpData, metric="ERWP", arg=exp)
+			writeBatchMetrics(erwpIntervals, "ERWP", csvPath, "w_{}".format(exp))
@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+
+# Converts device logs to the binary traces replayed by the simulation, and
+# back; the layout is described in TraceFormat.h. Both directions stream the
+# records, so traces of any length never have to fit in memory.
+
+import argparse
+import csv
+import heapq
+import mmap
+import struct
+import sys
+from decimal import Decimal
+
+FILE_MAGIC = b"SDSTRACE"
+VERSION = 1
+ARRIVAL = 1
+SIZED_ARRIVAL = 2
+WIFI_ON = 3
+WIFI_OFF = 4
+MAX_TIME = 2 ** 63 - 1
+EVENTS = {ARRIVAL: "arrival", SIZED_ARRIVAL: "arrival", WIFI_ON: "on", WIFI_OFF: "off"}
+
+
+def putSignedVarint(out, value):
+	value = (value << 1) ^ (value >> 63)
+	while value >= 0x80:
+		out.append((value & 0x7f) | 0x80)
+		value >>= 7
+	out.append(value)
+
+
+class TraceWriter:
+	def __init__(self, path, scaleExp):
+		self.file = open(path, "wb")
+		self.scaleExp = scaleExp
+		self.lastTime = 0
+		self.records = 0
+		self.buffer = bytearray(FILE_MAGIC + struct.pack("<Ii", VERSION, scaleExp))
+
+	def write(self, kind, time, size=None):
+		self.buffer.append(kind)
+		putSignedVarint(self.buffer, time - self.lastTime)
+		if kind == SIZED_ARRIVAL:
+			self.buffer += struct.pack("<d", size)
+		self.lastTime = time
+		self.records += 1
+		if len(self.buffer) >= 1 << 16:
+			self.file.write(self.buffer)
+			self.buffer.clear()
+
+	def close(self):
+		self.file.write(self.buffer)
+		self.file.close()
+
+
+class TraceReader:
+	"""Yields (kind, raw time, size) of the records of a memory-mapped trace."""
+
+	def __init__(self, path):
+		self.file = open(path, "rb")
+		self.data = mmap.mmap(self.file.fileno(), 0, access=mmap.ACCESS_READ)
+		if self.data[:8] != FILE_MAGIC:
+			raise ValueError("{} is not a trace".format(path))
+		version, self.scaleExp = struct.unpack_from("<Ii", self.data, 8)
+		if version != VERSION:
+			raise ValueError("{} has trace version {}, {} expected".format(path, version, VERSION))
+
+	def __enter__(self):
+		return self
+
+	def __exit__(self, *args):
+		self.data.close()
+		self.file.close()
+
+	def __iter__(self):
+		data = self.data
+		position = 16
+		time = 0
+		while position < len(data):
+			kind = data[position]
+			position += 1
+			value = 0
+			shift = 0
+			while True:
+				byte = data[position]
+				position += 1
+				value |= (byte & 0x7f) << shift
+				if not byte & 0x80:
+					break
+				shift += 7
+			time += (value >> 1) ^ -(value & 1)
+			size = None
+			if kind == SIZED_ARRIVAL:
+				size, = struct.unpack_from("<d", data, position)
+				position += 8
+			yield kind, time, size
+
+	def seconds(self, time):
+		return Decimal(time).scaleb(self.scaleExp)
+
+
+def readLog(path, scaleExp):
+	# rows of time (s), event (arrival, on or off) and optional size (s)
+	with open(path, "r", encoding="utf-8", newline="") as log:
+		last = None
+		for line, row in enumerate(csv.reader(log), start=1):
+			if not row or row[0].startswith("#") or row[0] == "time":
+				continue
+			time = int((Decimal(row[0]).scaleb(-scaleExp)).to_integral_value())
+			if not 0 <= time <= MAX_TIME:
+				raise ValueError("{}:{}: time {} s does not fit in the 64-bit times of scale exponent {} (0 to {} s), use a larger --scaleExp".format(
+					path, line, row[0].strip(), scaleExp, Decimal(MAX_TIME).scaleb(scaleExp)))
+			if last is not None and time < last:
+				raise ValueError("{}:{}: the log is not in time order".format(path, line))
+			last = time
+			event = row[1].strip().lower()
+			if event == "arrival":
+				size = row[2].strip() if len(row) > 2 else ""
+				yield (time, SIZED_ARRIVAL, float(size)) if size else (time, ARRIVAL, None)
+			elif event in ("on", "1"):
+				yield time, WIFI_ON, None
+			elif event in ("off", "0"):
+				yield time, WIFI_OFF, None
+			else:
+				raise ValueError("{}:{}: unknown event {}".format(path, line, row[1]))
+
+
+def convert(args):
+	# the logs are merged by time, e.g. the arrivals and the connectivity of a device
+	writer = TraceWriter(args.output, args.scaleExp)
+	for time, kind, size in heapq.merge(*(readLog(path, args.scaleExp) for path in args.logs), key=lambda record: record[0]):
+		writer.write(kind, time, size)
+	writer.close()
+	print("{} records written to {}".format(writer.records, args.output))
+
+
+def dump(args):
+	with TraceReader(args.trace) as trace:
+		out = csv.writer(sys.stdout, lineterminator="\n")
+		out.writerow(["time", "event", "size"])
+		for kind, time, size in trace:
+			out.writerow([trace.seconds(time), EVENTS.get(kind, kind), "" if size is None else repr(size)])
+
+
+def info(args):
+	with TraceReader(args.trace) as trace:
+		counts = {kind: 0 for kind in EVENTS}
+		periods = {WIFI_ON: [0, 0], WIFI_OFF: [0, 0]}
+		sizes = [0, 0.0]
+		first = last = None
+		state, since = None, None
+		for kind, time, size in trace:
+			counts[kind] = counts.get(kind, 0) + 1
+			first = time if first is None else first
+			last = time
+			if kind == SIZED_ARRIVAL:
+				sizes[0] += 1
+				sizes[1] += size
+			elif kind in periods and kind != state:
+				if state is not None:
+					periods[state][0] += 1
+					periods[state][1] += time - since
+				state, since = kind, time
+
+		print("scale exponent {}, {} to {} s".format(trace.scaleExp, trace.seconds(first or 0), trace.seconds(last or 0)))
+		print("arrivals: {} ({} with a size{})".format(counts[ARRIVAL] + counts[SIZED_ARRIVAL], counts[SIZED_ARRIVAL], ", mean {:.4f} s".format(sizes[1] / sizes[0]) if sizes[0] else ""))
+		for kind, name in ((WIFI_ON, "on"), (WIFI_OFF, "off")):
+			count, total = periods[kind]
+			print("WiFi {}: {} transitions, {} complete periods{}".format(name, counts[kind], count, ", mean {:.4f} s".format(float(trace.seconds(total)) / count) if count else ""))
+
+
+if __name__ == "__main__":
+	parser = argparse.ArgumentParser(description="Converts device logs to binary traces (see TraceFormat.h), and back")
+	subparsers = parser.add_subparsers(dest="command", required=True)
+	convertParser = subparsers.add_parser("convert", help="write a trace from CSV logs of time (s), event (arrival, on, off) and optional size (s), merged by time")
+	convertParser.add_argument("logs", type=str, nargs="+")
+	convertParser.add_argument("--output", "-o", type=str, required=True)
+	convertParser.add_argument("--scaleExp", type=int, default=-12, help="simtime scale exponent of the trace times (the one of the simulation avoids conversions); -12 covers about 106 days")
+	dumpParser = subparsers.add_parser("dump", help="print the records of a trace as CSV")
+	dumpParser.add_argument("trace", type=str)
+	infoParser = subparsers.add_parser("info", help="count the records of a trace, with the mean sizes and WiFi periods")
+	infoParser.add_argument("trace", type=str)
+	args = parser.parse_args()
+
+	{"convert": convert, "dump": dump, "info": info}[args.command](args)
@@ -6,7 +6,7 @@ import matplotlib as mpl
 import matplotlib.pyplot as plt
 import numpy as np
 import re
-import copy
+from columnarVectors import ColumnarVectorFile
 
 
 def setupPlots():
@@ -50,37 +50,129 @@ def getTupleValues(index, data):
 	return list(map(lambda e: e[index], data))
 
 
-def loadData(inputDir, config):
+def loadColumnarVectors(path, vectorNames=None):
+	# same shape as a run of the JSON export, with numpy arrays as time and value
+	vectors = []
+	with ColumnarVectorFile(path) as input:
+		for vector in input.vectors:
+			if vectorNames and vector["name"] not in vectorNames:
+				continue
+			times, values = input.read(vector)
+			vectors.append({"module": vector["module"], "name": vector["name"], "time": times, "value": values})
+	return {"vectors": vectors}
+
+
+def loadData(inputDir, config, vectorNames=None):
+	# reads the JSON files of exportStats.sh or directly the .cvec files of
+	# ColumnarOutputVectorManager, of which only the vectorNames are decoded
 	print("Loading data...")
 
 	selectedFiles = []
 	for root, dirs, files in os.walk(inputDir):
 		for file in files:
-			if config in file and file.endswith(".json"):
+			if config in file and (file.endswith(".json") or file.endswith(".cvec")):
 				selectedFiles.append(os.path.join(root, file))
 
 	dataDict = {}
 	dataKeys = {"seed": [], "renegingTime": []}
 	for file in selectedFiles:
-		with open(file, "r", encoding="utf-8") as input:
-			match = re.search(r"seed=[0-9]+,renegingTime=[0-9]+", file)
-			if match:
-				keys = match.group(0).split(",")
-				fileData = json.load(input)
+		match = re.search(r"seed=[0-9]+,renegingTime=[0-9]+", file)
+		if match:
+			keys = match.group(0).split(",")
+			_, _, renTimeVal = keys[1].partition("=")
+			_, _, seedVal = keys[0].partition("=")
+			if file.endswith(".cvec"):
+				dataDict.setdefault(renTimeVal, {})[seedVal] = loadColumnarVectors(file, vectorNames)
+			else:
+				with open(file, "r", encoding="utf-8") as input:
+					fileData = json.load(input)
 				if len(fileData.keys()) > 1:
 					raise Exception("Only one key element expected; found {}".format(len(fileData.keys())))
 				outermostKey = list(fileData.keys())[0]
-				_, _, renTimeVal = keys[1].partition("=")
-				_, _, seedVal = keys[0].partition("=")
 				dataDict.setdefault(renTimeVal, {})[seedVal] = fileData[outermostKey]
-				for elem in keys:
-					key, delim, value = elem.partition("=")
-					if value not in dataKeys[key]:
-						dataKeys[key].append(value)
+			for elem in keys:
+				key, delim, value = elem.partition("=")
+				if value not in dataKeys[key]:
+					dataKeys[key].append(value)
 
 	return dataDict, dataKeys
 
 
+def readScalarFile(path):
+	scalars = {}
+	with open(path, "r", encoding="utf-8") as input:
+		for line in input:
+			if not line.startswith("scalar "):
+				continue
+			_, module, name, value = line.split(maxsplit=3)
+			scalars[(module, name)] = float(value)
+	return scalars
+
+
+def loadScalars(inputDir, config):
+	print("Loading scalars...")
+
+	dataDict = {}
+	dataKeys = {"seed": [], "renegingTime": []}
+	for root, dirs, files in os.walk(inputDir):
+		for file in files:
+			if config not in file or not file.endswith(".sca"):
+				continue
+			match = re.search(r"seed=([0-9]+),renegingTime=([0-9]+)", file)
+			if not match:
+				continue
+			seedVal, renTimeVal = match.group(1), match.group(2)
+			dataDict.setdefault(renTimeVal, {})[seedVal] = readScalarFile(os.path.join(root, file))
+			if seedVal not in dataKeys["seed"]:
+				dataKeys["seed"].append(seedVal)
+			if renTimeVal not in dataKeys["renegingTime"]:
+				dataKeys["renegingTime"].append(renTimeVal)
+
+	return dataDict, dataKeys
+
+
+def loadPipelineScalars(inputDir, config, network="MultiDeadlineNetwork"):
+	# one file per seed with a pipeline per deadline: the scalars of every
+	# pipeline are returned as if they came from a FullOffloadingNetwork run
+	print("Loading pipeline scalars...")
+
+	dataDict = {}
+	dataKeys = {"seed": [], "renegingTime": []}
+	pipeline = re.compile(r"^{}\.(pipeline\[[0-9]+\])\.(.+)$".format(network))
+	for root, dirs, files in os.walk(inputDir):
+		for file in files:
+			if config not in file or not file.endswith(".sca"):
+				continue
+			match = re.search(r"seed=([0-9]+)\.sca$", file)
+			if not match:
+				continue
+			seedVal = match.group(1)
+			perPipeline = {}
+			for (module, name), value in readScalarFile(os.path.join(root, file)).items():
+				moduleMatch = pipeline.match(module)
+				if moduleMatch:
+					perPipeline.setdefault(moduleMatch.group(1), {})[("FullOffloadingNetwork." + moduleMatch.group(2), name)] = value
+			for scalars in perPipeline.values():
+				renTimeVal = "{:.0f}".format(scalars[("FullOffloadingNetwork.sink", "deadline")])
+				dataDict.setdefault(renTimeVal, {})[seedVal] = scalars
+				if renTimeVal not in dataKeys["renegingTime"]:
+					dataKeys["renegingTime"].append(renTimeVal)
+			if seedVal not in dataKeys["seed"]:
+				dataKeys["seed"].append(seedVal)
+
+	return dataDict, dataKeys
+
+
+def filterScalar(data, name, moduleName="FullOffloadingNetwork.sink"):
+	values = {}
+	for renTime, seedsData in data.items():
+		values[renTime] = {}
+		for seed, scalars in seedsData.items():
+			if (moduleName, name) in scalars:
+				values[renTime][seed] = scalars[(moduleName, name)]
+	return values
+
+
 def runningAvg(x):
 	return np.cumsum(x) / np.arange(1, x.size + 1)
 	
@@ -137,6 +229,22 @@ def quantizeData(timeData, valData, step=10.0):
 	return np.array(quantizedTimes), np.array(quantizedValues)
 
 
+def hasVector(data, measureKey):
+	return any(vec["name"] == measureKey for seedsData in data.values() for simData in seedsData.values() for vec in simData["vectors"])
+
+
+def mergeWindows(timeData, meanData, countData):
+	# pools the windows recorded by windowStats in every run: the mean of a
+	# window is weighted by its number of samples
+	times = np.concatenate([np.asarray(t, dtype=float) for t in timeData])
+	means = np.concatenate([np.asarray(m, dtype=float) for m in meanData])
+	counts = np.concatenate([np.asarray(c, dtype=float) for c in countData])
+	windows, ids = np.unique(times, return_inverse=True)
+	pooledCounts = np.bincount(ids, weights=counts)
+	pooledSums = np.bincount(ids, weights=means * counts)
+	return windows, pooledSums / pooledCounts
+
+
 def splitJobsByQueue(timesList, serviceTimes, queuesVals):
 	assert len(timesList) == 2
 	for i in range(2):
@@ -168,7 +276,8 @@ def splitJobsByQueue(timesList, serviceTimes, queuesVals):
 def extractWiFiCellularData(data, keys, saveDir=None):
 	print("Extracting WiFi and Cellular data...")
 	
-	updatedData = copy.deepcopy(data)
+	# only the runs are replaced, their vectors are shared with data
+	updatedData = {renTime: dict(seedsData) for renTime, seedsData in data.items()}
 	for renTime in keys["renegingTime"]:
 		sTimes, serviceTimeValues, legends = filterData(data, "totalServiceTime:vector", renTime)
 		qTimes, queuesVisitedValues, _ = filterData(data, "queuesVisited:vector", renTime)	
@@ -5,14 +5,26 @@ import matplotlib as mpl
 import matplotlib.pyplot as plt
 import numpy as np
 import os
-from utils import loadData, runningAvg, filterData, quantizeData, setupPlots, plotGraph, getTupleValues
+from utils import loadData, runningAvg, filterData, quantizeData, setupPlots, plotGraph, getTupleValues, hasVector, mergeWindows
 
 
 def plotTrends(data, keys, outputDir, vector, plotTitle, fileName, moduleName=None):
 	print("Plotting Service Times for {}...".format(plotTitle))
 	
+	# runs recorded with windowStats already hold the 100s windows
+	statistic, _, _ = vector.partition(":")
+	windowed = hasVector(data, statistic + ":windowMean")
+	
 	plotData = []
 	for renTime in keys["renegingTime"]:
+		if windowed:
+			times, means, _ = filterData(data, statistic + ":windowMean", renTime, moduleName)
+			_, counts, _ = filterData(data, statistic + ":windowCount", renTime, moduleName)
+			seeds = [seed for seed in keys["seed"] if seed in means]
+			qTimes, qValues = mergeWindows([times[seed] for seed in seeds], [means[seed] for seed in seeds], [counts[seed] for seed in seeds])
+			plotData.append((qTimes, runningAvg(qValues)))
+			continue
+		
 		times, values, _ = filterData(data, vector, renTime, moduleName)
 		
 		assert len(times) == len(values)
@@ -41,10 +53,11 @@ if __name__ == "__main__":
 	plotsPath = os.path.join(args.outputDir, "plots")
 	os.makedirs(plotsPath, exist_ok=True)
 	
-	data, keys = loadData(args.inputDir, "SetupAnalysis")
+	vectors = ["jobServiceTime:vector", "wifiActiveTime:vector", "cellActiveTime:vector", "jobServiceTime:vector"]
+	windowVectors = [vec.replace(":vector", suffix) for vec in vectors for suffix in [":windowMean", ":windowCount"]]
+	data, keys = loadData(args.inputDir, "SetupAnalysis", vectors + windowVectors)
 	setupPlots()
 	
-	vectors = ["jobServiceTime:vector", "wifiActiveTime:vector", "cellActiveTime:vector", "jobServiceTime:vector"]
 	modules = ["FullOffloadingNetwork.cellularQueue", None, None, "FullOffloadingNetwork.wifiQueue"]
 	fileNames = ["SetupAnalysis_ServiceTime_CellularQueue.png", "SetupAnalysis_WiFiQueue_StateDistribution.png", "SetupAnalysis_CellularQueue_StateDistribution.png", "SetupAnalysis_ServiceTime_WiFiQueue.png"]
 	titles = ["Cellular Queue", "WiFi State Distribution", "Cellular State Distribution", "WiFi Queue"]
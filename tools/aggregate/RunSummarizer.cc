@@ -0,0 +1,154 @@
+/*
+ * RunSummarizer.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "RunSummarizer.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <fnmatch.h>
+
+#include "ColumnarVectorReader.h"
+
+namespace
+{
+    bool endsWith(const std::string& text, const std::string& suffix)
+    {
+        return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    // next space separated token of a .vec line; quoted tokens keep their spaces
+    std::string nextToken(const char *&position, const char *end)
+    {
+        while (position < end && (*position == ' ' || *position == '\t'))
+            position++;
+        std::string token;
+        if (position < end && *position == '"') {
+            for (position++; position < end && *position != '"'; position++) {
+                if (*position == '\\' && position + 1 < end)
+                    position++;
+                token.push_back(*position);
+            }
+            position++;
+            return token;
+        }
+        const char *start = position;
+        while (position < end && *position != ' ' && *position != '\t')
+            position++;
+        return std::string(start, position);
+    }
+}
+
+RunSummarizer::RunSummarizer()
+{
+    setPatterns(RunSummary::RESPONSE_TIME, "*.sink", "totalResponseTime:vector");
+    setPatterns(RunSummary::WIFI_SERVICE_TIME, "*.wifiQueue", "jobServiceTime:vector");
+    setPatterns(RunSummary::CELLULAR_SERVICE_TIME, "*.cellularQueue", "jobServiceTime:vector");
+}
+
+void RunSummarizer::setPatterns(RunSummary::Role role, const std::string& module, const std::string& name)
+{
+    modulePatterns[role] = module;
+    namePatterns[role] = name;
+}
+
+RunSummary::Role RunSummarizer::roleOf(const std::string& module, const std::string& name) const
+{
+    for (int role = RunSummary::RESPONSE_TIME; role < RunSummary::ROLES; role++) {
+        if (fnmatch(modulePatterns[role].c_str(), module.c_str(), 0) == 0 && fnmatch(namePatterns[role].c_str(), name.c_str(), 0) == 0)
+            return (RunSummary::Role)role;
+    }
+    return RunSummary::NONE;
+}
+
+RunSummary RunSummarizer::summarize(const std::string& fileName) const
+{
+    if (endsWith(fileName, ".cvec"))
+        return summarizeCvec(fileName);
+    return summarizeVec(fileName);
+}
+
+RunSummary RunSummarizer::summarizeCvec(const std::string& fileName) const
+{
+    RunSummary summary;
+    ColumnarVectorReader reader(fileName);
+    for (const ColumnarVectorFormat::VectorInfo& vector : reader.getIndex().vectors) {
+        RunSummary::Role role = roleOf(vector.module, vector.name);
+        if (role == RunSummary::NONE)
+            continue;
+        summary.sum[role] += vector.sum;
+        summary.count[role] += vector.samples;
+    }
+    return summary;
+}
+
+RunSummary RunSummarizer::summarizeVec(const std::string& fileName) const
+{
+    FILE *file = std::fopen(fileName.c_str(), "rb");
+    if (!file)
+        throw std::runtime_error("cannot open " + fileName);
+
+    RunSummary summary;
+    std::vector<signed char> roles;     // by vector id
+    std::vector<char> buffer(1 << 20);
+    size_t filled = 0;
+    bool atEnd = false;
+    while (!atEnd) {
+        size_t read = std::fread(buffer.data() + filled, 1, buffer.size() - filled, file);
+        filled += read;
+        atEnd = read == 0;
+        if (atEnd && filled > 0 && buffer[filled - 1] != '\n')
+            buffer[filled++] = '\n';    // room is left by the carry-over below
+
+        const char *line = buffer.data();
+        const char *end = buffer.data() + filled;
+        const char *newline;
+        while ((newline = (const char *)std::memchr(line, '\n', end - line)) != nullptr) {
+            if (*line >= '0' && *line <= '9') {
+                // data line: vector id, [event], [time], value
+                char *position;
+                unsigned long id = std::strtoul(line, &position, 10);
+                if (id < roles.size() && roles[id] != RunSummary::NONE) {
+                    const char *last = newline;
+                    while (last > position && (last[-1] == '\r' || last[-1] == ' ' || last[-1] == '\t'))
+                        last--;
+                    const char *value = last;
+                    while (value > position && value[-1] != ' ' && value[-1] != '\t')
+                        value--;
+                    summary.sum[(int)roles[id]] += std::strtod(value, nullptr);
+                    summary.count[(int)roles[id]]++;
+                }
+            }
+            else if (newline - line > 7 && std::strncmp(line, "vector ", 7) == 0) {
+                // vector declaration: vector id module name [columns]
+                const char *position = line + 7;
+                unsigned long id = std::strtoul(nextToken(position, newline).c_str(), nullptr, 10);
+                std::string module = nextToken(position, newline);
+                std::string name = nextToken(position, newline);
+                if (id >= roles.size())
+                    roles.resize(id + 1, RunSummary::NONE);
+                roles[id] = roleOf(module, name);
+            }
+            line = newline + 1;
+        }
+
+        // keep the incomplete last line for the next read
+        filled = end - line;
+        if (filled >= buffer.size() - 1)
+            buffer.resize(buffer.size() * 2);
+        std::memmove(buffer.data(), line, filled);
+    }
+
+    bool failed = std::ferror(file);
+    std::fclose(file);
+    if (failed)
+        throw std::runtime_error("cannot read " + fileName);
+    return summary;
+}
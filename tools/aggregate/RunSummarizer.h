@@ -0,0 +1,50 @@
+/*
+ * RunSummarizer.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef RUNSUMMARIZER_H_
+#define RUNSUMMARIZER_H_
+
+#include <string>
+
+/**
+ * Sums and counts of the vectors analysis/analysis.py needs from a run:
+ * response times of the sink and service times of the WiFi and cellular
+ * queues.
+ */
+struct RunSummary
+{
+    enum Role { NONE = 0, RESPONSE_TIME, WIFI_SERVICE_TIME, CELLULAR_SERVICE_TIME, ROLES };
+
+    double sum[ROLES] = {};
+    long count[ROLES] = {};
+};
+
+/**
+ * Reads a .vec or .cvec file in one pass, keeping only the sums and counts
+ * of the selected vectors, so memory does not depend on the file size. Of a
+ * .cvec file only the index is read, since it already holds them.
+ */
+class RunSummarizer
+{
+    private:
+        std::string modulePatterns[RunSummary::ROLES];
+        std::string namePatterns[RunSummary::ROLES];
+
+        RunSummary::Role roleOf(const std::string& module, const std::string& name) const;
+        RunSummary summarizeVec(const std::string& fileName) const;
+        RunSummary summarizeCvec(const std::string& fileName) const;
+
+    public:
+        RunSummarizer();
+
+        // glob patterns of module and name of the vectors of a role
+        void setPatterns(RunSummary::Role role, const std::string& module, const std::string& name);
+
+        RunSummary summarize(const std::string& fileName) const;
+};
+
+#endif /* RUNSUMMARIZER_H_ */
@@ -0,0 +1,273 @@
+/*
+ * main.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ *
+ * Computes the per-run MRT, MEC and ERWP of a configuration from its .vec or
+ * .cvec files and writes the ConfidenceIntervals_*.csv files of
+ * analysis/analysis.py. Runs are read by a pool of threads, one file at a
+ * time each, and only their sums are kept.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "OffloadingMetrics.h"
+#include "RunSummarizer.h"
+
+namespace
+{
+    struct RunFile {
+        std::string path;
+        long deadline;
+        long seed;
+    };
+
+    struct RunMetrics {
+        long seed;
+        double mrt;
+        double mec;
+    };
+
+    void usage(const char *program)
+    {
+        std::cerr << "Usage: " << program << " [options]\n"
+                  << "  -d DIR             results directory, searched recursively (default: results)\n"
+                  << "  -c CONFIG          configuration (default: BatchExecution)\n"
+                  << "  -o DIR             output directory of the CSV files (default: analysis/csv)\n"
+                  << "  -w W1,W2,...       ERWP exponents (default: 0.1,0.5,0.9)\n"
+                  << "  -e WIFI,CELLULAR   power coefficients (default: 0.7,2.5)\n"
+                  << "  -l LEVEL           confidence level (default: 0.90)\n"
+                  << "  -j N               files read in parallel (default: number of cores)\n"
+                  << "  -r FILE            also write the metrics of every run as CSV\n";
+    }
+
+    std::vector<double> parseList(const char *text)
+    {
+        std::vector<double> values;
+        std::string list(text);
+        size_t start = 0;
+        while (start <= list.size()) {
+            size_t comma = list.find(',', start);
+            if (comma == std::string::npos)
+                comma = list.size();
+            values.push_back(std::atof(list.substr(start, comma - start).c_str()));
+            start = comma + 1;
+        }
+        return values;
+    }
+
+    // same file selection as utils.loadData
+    void findRunFiles(const std::string& directory, const std::string& config, std::vector<RunFile>& files)
+    {
+        static const std::regex keys("seed=([0-9]+),renegingTime=([0-9]+)");
+        DIR *dir = opendir(directory.c_str());
+        if (!dir)
+            throw std::runtime_error("cannot read directory " + directory);
+        while (dirent *entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name == "." || name == "..")
+                continue;
+            std::string path = directory + "/" + name;
+            struct stat info;
+            if (stat(path.c_str(), &info) != 0)
+                continue;
+            if (S_ISDIR(info.st_mode)) {
+                findRunFiles(path, config, files);
+                continue;
+            }
+            bool vec = name.size() > 4 && name.compare(name.size() - 4, 4, ".vec") == 0;
+            bool cvec = name.size() > 5 && name.compare(name.size() - 5, 5, ".cvec") == 0;
+            std::smatch match;
+            if (name.find(config) != std::string::npos && (vec || cvec) && std::regex_search(name, match, keys))
+                files.push_back({ path, std::atol(match[2].str().c_str()), std::atol(match[1].str().c_str()) });
+        }
+        closedir(dir);
+    }
+
+    void writeIntervals(const std::string& fileName, const std::map<long, RunningStatistic>& values, double confidence)
+    {
+        FILE *csv = std::fopen(fileName.c_str(), "w");
+        if (!csv)
+            throw std::runtime_error("cannot write " + fileName);
+        std::fprintf(csv, "Deadline [s], Deadline [min], Reneging Rate r, Mean, Variance, Left Value, Right Value\n");
+        for (const auto& entry : values) {
+            long deadlineMin = entry.first / 60;
+            const RunningStatistic& runs = entry.second;
+            double halfWidth = OffloadingMetrics::confidenceHalfWidth(runs, confidence);
+            std::fprintf(csv, "%ld, %ld, %.4f, %.4f, %.4f, %.4f, %.4f\n", entry.first, deadlineMin, 1.0 / deadlineMin, runs.getMean(), runs.getVariance(), runs.getMean() - halfWidth, runs.getMean() + halfWidth);
+        }
+        std::fclose(csv);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string resultDir = "results";
+    std::string config = "BatchExecution";
+    std::string outputDir = "analysis/csv";
+    std::vector<double> exponents = { 0.1, 0.5, 0.9 };
+    std::vector<double> powerCoefficients = { 0.7, 2.5 };
+    double confidence = 0.90;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string runsFile;
+
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "-h" || option == "--help") {
+            usage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc || option.size() != 2 || option[0] != '-') {
+            usage(argv[0]);
+            return 1;
+        }
+        const char *value = argv[++i];
+        switch (option[1]) {
+            case 'd': resultDir = value; break;
+            case 'c': config = value; break;
+            case 'o': outputDir = value; break;
+            case 'w': exponents = parseList(value); break;
+            case 'e': powerCoefficients = parseList(value); break;
+            case 'l': confidence = std::atof(value); break;
+            case 'j': threads = std::atoi(value); break;
+            case 'r': runsFile = value; break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (powerCoefficients.size() != 2) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        std::vector<RunFile> files;
+        findRunFiles(resultDir, config, files);
+        if (files.empty())
+            throw std::runtime_error("no .vec or .cvec files of " + config + " in " + resultDir);
+        // largest files first, so that no thread is left with a big one at the end
+        std::vector<std::pair<off_t, size_t>> order;
+        for (size_t i = 0; i < files.size(); i++) {
+            struct stat info;
+            order.emplace_back(stat(files[i].path.c_str(), &info) == 0 ? info.st_size : 0, i);
+        }
+        std::sort(order.rbegin(), order.rend());
+
+        RunSummarizer summarizer;
+        std::map<long, std::map<long, RunMetrics>> runs;   // by deadline and seed
+        std::mutex runsMutex;
+        std::atomic<size_t> next(0);
+        std::atomic<size_t> done(0);
+        std::string failure;
+        auto worker = [&]() {
+            for (size_t i = next++; i < order.size(); i = next++) {
+                const RunFile& file = files[order[i].second];
+                RunMetrics metrics;
+                metrics.seed = file.seed;
+                try {
+                    RunSummary summary = summarizer.summarize(file.path);
+                    double energy = summary.sum[RunSummary::WIFI_SERVICE_TIME] * powerCoefficients[0] + summary.sum[RunSummary::CELLULAR_SERVICE_TIME] * powerCoefficients[1];
+                    metrics.mrt = OffloadingMetrics::meanResponseTime(summary.sum[RunSummary::RESPONSE_TIME], summary.count[RunSummary::RESPONSE_TIME]);
+                    metrics.mec = OffloadingMetrics::meanEnergyConsumption(energy, summary.count[RunSummary::WIFI_SERVICE_TIME] + summary.count[RunSummary::CELLULAR_SERVICE_TIME]);
+                }
+                catch (const std::exception& e) {
+                    std::lock_guard<std::mutex> lock(runsMutex);
+                    failure = e.what();
+                    next = order.size();
+                    return;
+                }
+
+                std::lock_guard<std::mutex> lock(runsMutex);
+                if (!runs[file.deadline].emplace(file.seed, metrics).second)
+                    std::cerr << "Warning: seed " << file.seed << " of deadline " << file.deadline << "s found twice, " << file.path << " ignored\n";
+                if (++done % 100 == 0 || done == files.size())
+                    std::cerr << "\r" << done << " of " << files.size() << " files" << std::flush;
+            }
+        };
+        std::vector<std::thread> pool;
+        for (int t = 1; t < std::max(1, std::min<int>(threads, files.size())); t++)
+            pool.emplace_back(worker);
+        worker();
+        for (std::thread& thread : pool)
+            thread.join();
+        std::cerr << "\n";
+        if (!failure.empty())
+            throw std::runtime_error(failure);
+
+        FILE *runsCsv = nullptr;
+        if (!runsFile.empty()) {
+            runsCsv = std::fopen(runsFile.c_str(), "w");
+            if (!runsCsv)
+                throw std::runtime_error("cannot write " + runsFile);
+            std::fprintf(runsCsv, "Deadline [s], Seed, MRT, MEC");
+            for (double w : exponents)
+                std::fprintf(runsCsv, ", %s", OffloadingMetrics::erwpName(w).c_str());
+            std::fprintf(runsCsv, "\n");
+        }
+
+        // runs without jobs of a kind have no value and are skipped, as in analysis.py
+        std::map<long, RunningStatistic> mrt, mec;
+        std::vector<std::map<long, RunningStatistic>> erwp(exponents.size());
+        for (const auto& deadline : runs) {
+            for (const auto& seed : deadline.second) {
+                const RunMetrics& metrics = seed.second;
+                if (!std::isnan(metrics.mrt))
+                    mrt[deadline.first].collect(metrics.mrt);
+                if (!std::isnan(metrics.mec))
+                    mec[deadline.first].collect(metrics.mec);
+                if (runsCsv)
+                    std::fprintf(runsCsv, "%ld, %ld, %.6f, %.6f", deadline.first, metrics.seed, metrics.mrt, metrics.mec);
+                for (size_t i = 0; i < exponents.size(); i++) {
+                    double value = OffloadingMetrics::erwp(metrics.mec, metrics.mrt, exponents[i]);
+                    if (!std::isnan(value))
+                        erwp[i][deadline.first].collect(value);
+                    if (runsCsv)
+                        std::fprintf(runsCsv, ", %.6f", value);
+                }
+                if (runsCsv)
+                    std::fprintf(runsCsv, "\n");
+            }
+        }
+        if (runsCsv)
+            std::fclose(runsCsv);
+
+        writeIntervals(outputDir + "/ConfidenceIntervals_MRT_total.csv", mrt, confidence);
+        writeIntervals(outputDir + "/ConfidenceIntervals_MEC_total.csv", mec, confidence);
+        for (size_t i = 0; i < exponents.size(); i++)
+            writeIntervals(outputDir + "/ConfidenceIntervals_" + OffloadingMetrics::erwpName(exponents[i]) + "_total.csv", erwp[i], confidence);
+
+        std::printf("%10s %6s %8s %8s", "Deadline", "runs", "MRT", "MEC");
+        for (double w : exponents)
+            std::printf(" %12s", OffloadingMetrics::erwpName(w).c_str());
+        std::printf("\n");
+        for (const auto& deadline : runs) {
+            std::printf("%9lds %6zu %8.4f %8.4f", deadline.first, deadline.second.size(), mrt[deadline.first].getMean(), mec[deadline.first].getMean());
+            for (size_t i = 0; i < exponents.size(); i++)
+                std::printf(" %12.4f", erwp[i][deadline.first].getMean());
+            std::printf("\n");
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
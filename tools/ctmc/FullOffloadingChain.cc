@@ -0,0 +1,377 @@
+/*
+ * FullOffloadingChain.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "FullOffloadingChain.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+FullOffloadingChain::FullOffloadingChain(const ModelParameters& parameters, int maxWaiting, int maxCellular)
+    : parameters(parameters), maxWaiting(maxWaiting), maxCellular(maxCellular)
+{
+    if (maxWaiting < 1 || maxCellular < 1)
+        throw std::runtime_error("truncation levels must be positive");
+    stateCount = 2 * 3 * (maxWaiting + 1) * (maxWaiting + 1) * (maxCellular + 1);
+
+    // the slowest mode of the chain is the length of the cellular queue
+    // (a job there takes 400s on average), so the aggregation step lumps by c
+    cellularLevels.levels = maxCellular + 1;
+    cellularLevels.level.resize(stateCount);
+    for (int i = 0; i < stateCount; i++)
+        cellularLevels.level[i] = i % (maxCellular + 1);
+    if (parameters.remoteServiceTime >= parameters.interArrivalTime)
+        throw std::runtime_error("the remote queue is not stable");
+}
+
+void FullOffloadingChain::generate(double renegingRate, const std::function<void(int, int, double)>& emit) const
+{
+    const double arrival = 1.0 / parameters.interArrivalTime;
+    const double wifiOff = 1.0 / parameters.wifiStateTime;
+    const double wifiOn = 1.0 / parameters.cellularStateTime;
+    const double wifiService = 1.0 / parameters.wifiServiceTime;
+    const double cellularService = 1.0 / parameters.cellularServiceTime;
+
+    for (int wifi = 0; wifi < 2; wifi++)
+    for (int head = 0; head < 3; head++)
+    for (int d = 0; d <= maxWaiting; d++)
+    for (int u = 0; u <= maxWaiting; u++)
+    for (int c = 0; c <= maxCellular; c++) {
+        // an idle server with waiting jobs and WiFi on is never observed
+        if (wifi && head == NONE && d + u > 0)
+            continue;
+
+        int from = index(wifi, head, d, u, c);
+        int cellular = c < maxCellular ? c + 1 : c;
+
+        // next job taken by the server, jobs with a deadline first
+        auto next = [&](int c) {
+            if (d > 0) return index(1, WITH_DEADLINE, d - 1, u, c);
+            if (u > 0) return index(1, WITHOUT_DEADLINE, d, u - 1, c);
+            return index(1, NONE, 0, 0, c);
+        };
+
+        // arrivals: a deadline is only set while WiFi is off
+        if (wifi) {
+            if (head == NONE)
+                emit(from, index(1, WITHOUT_DEADLINE, 0, 0, c), arrival);
+            else if (u < maxWaiting)
+                emit(from, index(1, head, d, u + 1, c), arrival);
+        }
+        else if (d < maxWaiting)
+            emit(from, index(0, head, d + 1, u, c), arrival);
+
+        // WiFi periods; a job in service is suspended, not interrupted
+        if (wifi)
+            emit(from, index(0, head, d, u, c), wifiOff);
+        else if (head == NONE)
+            emit(from, next(c), wifiOn);
+        else
+            emit(from, index(1, head, d, u, c), wifiOn);
+
+        if (wifi && head != NONE)
+            emit(from, next(c), wifiService);
+
+        // deadlines of waiting jobs and of the job in service or suspended;
+        // a job that finds the cellular queue at its truncation level is lost
+        if (d > 0)
+            emit(from, index(wifi, head, d - 1, u, cellular), d * renegingRate);
+        if (head == WITH_DEADLINE) {
+            if (wifi)
+                emit(from, next(cellular), renegingRate);
+            else
+                emit(from, index(0, NONE, d, u, cellular), renegingRate);
+        }
+
+        if (c > 0)
+            emit(from, index(wifi, head, d, u, c - 1), cellularService);
+    }
+}
+
+void FullOffloadingChain::build(double renegingRate)
+{
+    // two passes over the transitions: count the incoming ones of every
+    // state, then fill the transposed rows
+    inStart.assign(stateCount + 1, 0);
+    outRate.assign(stateCount, 0.0);
+    cellularLevels.up.assign(stateCount, 0.0);
+    cellularLevels.down.assign(stateCount, 0.0);
+    generate(renegingRate, [&](int from, int to, double rate) {
+        if (to == from)
+            return;
+        inStart[to + 1]++;
+        outRate[from] += rate;
+        int step = cellularLevels.level[to] - cellularLevels.level[from];
+        if (step == 1)
+            cellularLevels.up[from] += rate;
+        else if (step == -1)
+            cellularLevels.down[from] += rate;
+    });
+    for (int i = 0; i < stateCount; i++)
+        inStart[i + 1] += inStart[i];
+
+    inFrom.resize(inStart[stateCount]);
+    inRate.resize(inStart[stateCount]);
+    std::vector<int> fill(inStart.begin(), inStart.end() - 1);
+    generate(renegingRate, [&](int from, int to, double rate) {
+        if (to != from) {
+            inFrom[fill[to]] = from;
+            inRate[fill[to]] = rate;
+            fill[to]++;
+        }
+    });
+}
+
+FullOffloadingChain::Solution FullOffloadingChain::solve(double deadline, std::vector<double>& probabilities, double tolerance, int maxIterations)
+{
+    double renegingRate = 1.0 / deadline;
+    build(renegingRate);
+
+    if ((int)probabilities.size() != stateCount) {
+        probabilities.assign(stateCount, 0.0);
+        int reachable = 0;
+        for (int i = 0; i < stateCount; i++)
+            if (outRate[i] > 0.0)
+                reachable++;
+        for (int i = 0; i < stateCount; i++)
+            if (outRate[i] > 0.0)
+                probabilities[i] = 1.0 / reachable;
+    }
+
+    Solution solution;
+    solution.iterations = 0;
+    double change = 1.0;
+    while (change > tolerance && solution.iterations < maxIterations) {
+        aggregate(cellularLevels, probabilities);
+
+        change = 0.0;
+        double total = 0.0;
+        for (int i = 0; i < stateCount; i++) {
+            if (outRate[i] == 0.0)
+                continue;
+            double inflow = 0.0;
+            for (int k = inStart[i]; k < inStart[i + 1]; k++)
+                inflow += probabilities[inFrom[k]] * inRate[k];
+            double updated = inflow / outRate[i];
+            change += std::fabs(updated - probabilities[i]);
+            probabilities[i] = updated;
+            total += updated;
+        }
+        for (double& p : probabilities)
+            p /= total;
+        change /= total;
+        solution.iterations++;
+    }
+
+    // ||pi Q||_1
+    solution.residual = 0.0;
+    for (int i = 0; i < stateCount; i++) {
+        double inflow = 0.0;
+        for (int k = inStart[i]; k < inStart[i + 1]; k++)
+            inflow += probabilities[inFrom[k]] * inRate[k];
+        solution.residual += std::fabs(inflow - probabilities[i] * outRate[i]);
+    }
+
+    solution.metrics = computeMetrics(probabilities, renegingRate);
+    return solution;
+}
+
+void FullOffloadingChain::aggregate(const LevelAggregation& aggregation, std::vector<double>& probabilities) const
+{
+    // the chain lumped by level is a birth-death process: solve it exactly
+    // and rescale the current iterate so that it has the same level masses
+    // (iterative aggregation-disaggregation)
+    std::vector<double> mass(aggregation.levels, 0.0);
+    std::vector<double> up(aggregation.levels, 0.0);
+    std::vector<double> down(aggregation.levels, 0.0);
+    for (int i = 0; i < stateCount; i++) {
+        int level = aggregation.level[i];
+        mass[level] += probabilities[i];
+        up[level] += probabilities[i] * aggregation.up[i];
+        down[level] += probabilities[i] * aggregation.down[i];
+    }
+
+    std::vector<double> lumped(aggregation.levels, 0.0);
+    lumped[0] = 1.0;
+    double total = 1.0;
+    for (int l = 0; l + 1 < aggregation.levels; l++) {
+        if (mass[l] == 0.0 || down[l + 1] == 0.0)
+            break;
+        lumped[l + 1] = lumped[l] * (up[l] / mass[l]) / (down[l + 1] / mass[l + 1]);
+        total += lumped[l + 1];
+    }
+
+    for (int i = 0; i < stateCount; i++) {
+        int level = aggregation.level[i];
+        if (mass[level] > 0.0)
+            probabilities[i] *= lumped[level] / total / mass[level];
+    }
+}
+
+double FullOffloadingChain::lostWifiTime(const std::vector<double>& probabilities, double renegingRate) const
+{
+    const double wifiOff = 1.0 / parameters.wifiStateTime;
+    const double wifiOn = 1.0 / parameters.cellularStateTime;
+    const double wifiService = 1.0 / parameters.wifiServiceTime;
+
+    // a tagged job with a deadline, from its arrival until it is taken by the
+    // server: (wifi, head, k) with k jobs with a deadline ahead of it. The
+    // jobs behind it and those without a deadline never overtake it, so they
+    // are left out; starting the service of the tagged job is absorbing.
+    const int levels = maxWaiting;
+    const int size = 2 * 3 * levels;
+    auto waiting = [&](int wifi, int head, int k) { return (wifi * 3 + head) * levels + k; };
+
+    // M = -Q restricted to the transient states, row by row
+    std::vector<double> matrix(size * size, 0.0);
+    auto move = [&](int from, int to, double rate) {
+        matrix[from * size + from] += rate;
+        if (to >= 0)
+            matrix[from * size + to] -= rate;
+    };
+    for (int wifi = 0; wifi < 2; wifi++)
+    for (int head = 0; head < 3; head++)
+    for (int k = 0; k < levels; k++) {
+        int from = waiting(wifi, head, k);
+        if (wifi && head == NONE) {
+            matrix[from * size + from] = 1.0;
+            continue;
+        }
+        int next = k > 0 ? waiting(1, WITH_DEADLINE, k - 1) : -1;
+
+        if (wifi)
+            move(from, waiting(0, head, k), wifiOff);
+        else
+            move(from, head == NONE ? next : waiting(1, head, k), wifiOn);
+        if (wifi)
+            move(from, next, wifiService);
+        if (k > 0)
+            move(from, waiting(wifi, head, k - 1), k * renegingRate);
+        if (head == WITH_DEADLINE)
+            move(from, wifi ? next : waiting(0, NONE, k), renegingRate);
+        move(from, -1, renegingRate);
+    }
+
+    // M h = renegingRate gives the probability of reaching the deadline
+    // while waiting, M g = h the expected wait of the jobs that do (zero for
+    // the others)
+    std::vector<double> reneged(size, renegingRate);
+    std::vector<double> eliminated = matrix;
+    solveDense(eliminated, reneged);
+    std::vector<double> waited = reneged;
+    solveDense(matrix, waited);
+
+    // in service or suspended, a segment ends when WiFi changes state: the
+    // segment cut by the deadline is exponential with the rate of its state
+    const double servedRate = wifiService + wifiOff + renegingRate;
+    const double suspendedRate = wifiOn + renegingRate;
+    const double servedVisits = 1.0 / (1.0 - wifiOff / servedRate * wifiOn / suspendedRate);
+    const double served = servedVisits * (renegingRate / (servedRate * servedRate)
+            + wifiOff / servedRate * renegingRate / (suspendedRate * suspendedRate));
+
+    // arrivals see the time averages; a deadline is only set while WiFi is off
+    double total = 0.0;
+    for (int head = 0; head < 3; head++)
+    for (int d = 0; d < maxWaiting; d++)
+    for (int u = 0; u <= maxWaiting; u++)
+    for (int c = 0; c <= maxCellular; c++) {
+        int tagged = waiting(0, head, d);
+        total += probabilities[index(0, head, d, u, c)] * (waited[tagged] + (1.0 - reneged[tagged]) * served);
+    }
+    return total;
+}
+
+void FullOffloadingChain::solveDense(std::vector<double>& matrix, std::vector<double>& values)
+{
+    // Gaussian elimination with partial pivoting; matrix is overwritten
+    const int size = values.size();
+    for (int column = 0; column < size; column++) {
+        int pivot = column;
+        for (int row = column + 1; row < size; row++)
+            if (std::fabs(matrix[row * size + column]) > std::fabs(matrix[pivot * size + column]))
+                pivot = row;
+        if (matrix[pivot * size + column] == 0.0)
+            throw std::runtime_error("singular system");
+        if (pivot != column) {
+            for (int j = 0; j < size; j++)
+                std::swap(matrix[pivot * size + j], matrix[column * size + j]);
+            std::swap(values[pivot], values[column]);
+        }
+        for (int row = column + 1; row < size; row++) {
+            double factor = matrix[row * size + column] / matrix[column * size + column];
+            if (factor == 0.0)
+                continue;
+            for (int j = column; j < size; j++)
+                matrix[row * size + j] -= factor * matrix[column * size + j];
+            values[row] -= factor * values[column];
+        }
+    }
+    for (int row = size - 1; row >= 0; row--) {
+        for (int j = row + 1; j < size; j++)
+            values[row] -= matrix[row * size + j] * values[j];
+        values[row] /= matrix[row * size + row];
+    }
+}
+
+FullOffloadingChain::Metrics FullOffloadingChain::computeMetrics(const std::vector<double>& probabilities, double renegingRate) const
+{
+    const double arrival = 1.0 / parameters.interArrivalTime;
+    const double wifiOff = 1.0 / parameters.wifiStateTime;
+    const double wifiOn = 1.0 / parameters.cellularStateTime;
+    const double wifiService = 1.0 / parameters.wifiServiceTime;
+    const double remoteService = 1.0 / parameters.remoteServiceTime;
+
+    double wifiJobs = 0.0;
+    double cellularJobs = 0.0;
+    double deadlineJobs = 0.0;
+    double servingWithDeadline = 0.0;
+    double servingWithoutDeadline = 0.0;
+    double cellularBusy = 0.0;
+    double boundary = 0.0;
+
+    for (int wifi = 0; wifi < 2; wifi++)
+    for (int head = 0; head < 3; head++)
+    for (int d = 0; d <= maxWaiting; d++)
+    for (int u = 0; u <= maxWaiting; u++)
+    for (int c = 0; c <= maxCellular; c++) {
+        double p = probabilities[index(wifi, head, d, u, c)];
+        if (p == 0.0)
+            continue;
+        wifiJobs += p * (d + u + (head != NONE));
+        cellularJobs += p * c;
+        deadlineJobs += p * (d + (head == WITH_DEADLINE));
+        if (wifi && head == WITH_DEADLINE)
+            servingWithDeadline += p;
+        if (wifi && head == WITHOUT_DEADLINE)
+            servingWithoutDeadline += p;
+        if (c > 0)
+            cellularBusy += p;
+        if (d == maxWaiting || u == maxWaiting || c == maxCellular)
+            boundary += p;
+    }
+
+    // the DES only records the WiFi service time of jobs that complete it:
+    // a job with a deadline being served completes with probability
+    // completeOn (WiFi on) or completeOff (suspended), by memorylessness
+    double completeOn = wifiService / (wifiService + renegingRate + wifiOff);
+    completeOn /= 1.0 - wifiOff * wifiOn / ((wifiService + renegingRate + wifiOff) * (wifiOn + renegingRate));
+
+    Metrics metrics;
+    metrics.meanWifiJobs = wifiJobs;
+    metrics.meanCellularJobs = cellularJobs;
+    // the DES adds the WiFi time of a job to its response time when its
+    // service starts, is suspended or resumes: a job that reaches its
+    // deadline loses the time since the last of these (all its wait if it was
+    // never served), as QueueCustom::arrival resets the timestamp
+    metrics.responseTime = (wifiJobs + cellularJobs) / arrival - lostWifiTime(probabilities, renegingRate)
+            + 1.0 / (remoteService - arrival);
+    metrics.energy = (parameters.wifiPowerCoefficient * (servingWithoutDeadline + completeOn * servingWithDeadline)
+            + parameters.cellularPowerCoefficient * cellularBusy) / arrival;
+    metrics.offloadedRatio = renegingRate * deadlineJobs / arrival;
+    metrics.truncationMass = boundary;
+    return metrics;
+}
@@ -0,0 +1,97 @@
+/*
+ * FullOffloadingChain.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef FULLOFFLOADINGCHAIN_H_
+#define FULLOFFLOADINGCHAIN_H_
+
+#include <functional>
+#include <vector>
+
+#include "ModelParameters.h"
+
+/**
+ * Truncated CTMC of the Full Offloading model, as in the paper: exponential
+ * arrivals, WiFi/cellular periods, service times and deadlines (the DES uses
+ * a constant deadline, here it is approximated by an exponential one with the
+ * same mean, i.e. reneging rate 1/deadline; the ExponentialDeadline
+ * configuration simulates exactly this model).
+ *
+ * A state is (wifi, head, d, u, c):
+ *  - wifi: WiFi available or not;
+ *  - head: job in service (or suspended) in the WiFi queue, none, with a
+ *    deadline or without;
+ *  - d, u: waiting jobs with and without a deadline (jobs with a deadline are
+ *    served first, as in OffloadingQueue);
+ *  - c: jobs in the cellular queue.
+ * The remote queue (service of about one second) is taken as M/M/1.
+ */
+class FullOffloadingChain
+{
+    public:
+        enum Head { NONE = 0, WITH_DEADLINE = 1, WITHOUT_DEADLINE = 2 };
+
+        struct Metrics {
+            double meanWifiJobs;
+            double meanCellularJobs;
+            double responseTime;    // per job, in seconds, as recorded by the DES
+            double energy;          // per job, sum(powerCoefficient * serviceTime) as recorded by the DES
+            double offloadedRatio;  // jobs that reach their deadline and use the cellular network
+            double truncationMass;  // probability of the states on the truncation boundary
+        };
+
+        struct Solution {
+            Metrics metrics;
+            int iterations;
+            double residual;
+        };
+
+    private:
+        const ModelParameters& parameters;
+        int maxWaiting;
+        int maxCellular;
+        int stateCount;
+
+        // incoming transitions of every state (compressed rows of Q transposed)
+        std::vector<int> inStart;
+        std::vector<int> inFrom;
+        std::vector<double> inRate;
+        std::vector<double> outRate;
+
+        // partition of the states in levels that only change by one job per
+        // transition, with the rates of the transitions up and down a level
+        struct LevelAggregation {
+            int levels;
+            std::vector<int> level;
+            std::vector<double> up;
+            std::vector<double> down;
+        };
+        LevelAggregation cellularLevels;
+
+        int index(int wifi, int head, int d, int u, int c) const {
+            return (((wifi * 3 + head) * (maxWaiting + 1) + d) * (maxWaiting + 1) + u) * (maxCellular + 1) + c;
+        }
+
+        void generate(double renegingRate, const std::function<void(int, int, double)>& emit) const;
+        void build(double renegingRate);
+        void aggregate(const LevelAggregation& aggregation, std::vector<double>& probabilities) const;
+        // WiFi time of the jobs that reach their deadline that the DES does
+        // not record in their response time, per arriving job
+        double lostWifiTime(const std::vector<double>& probabilities, double renegingRate) const;
+        static void solveDense(std::vector<double>& matrix, std::vector<double>& values);
+        Metrics computeMetrics(const std::vector<double>& probabilities, double renegingRate) const;
+
+    public:
+        FullOffloadingChain(const ModelParameters& parameters, int maxWaiting, int maxCellular);
+
+        int getStateCount() const { return stateCount; }
+
+        // Gauss-Seidel on pi Q = 0; probabilities is used as the initial guess
+        // (e.g. the solution for the previous deadline) and holds the result
+        Solution solve(double deadline, std::vector<double>& probabilities, double tolerance, int maxIterations);
+};
+
+#endif /* FULLOFFLOADINGCHAIN_H_ */
@@ -0,0 +1,226 @@
+/*
+ * ModelParameters.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "ModelParameters.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    const char *NETWORK_NAME = "FullOffloadingNetwork.";
+
+    std::string trim(const std::string& text)
+    {
+        size_t begin = text.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos)
+            return "";
+        size_t end = text.find_last_not_of(" \t\r\n");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    // "**.sink.x", "*.sink.x" and "FullOffloadingNetwork.sink.x" all become "sink.x"
+    std::string normalizeKey(std::string key)
+    {
+        key = trim(key);
+        while (key.compare(0, 2, "*.") == 0 || key.compare(0, 3, "**.") == 0)
+            key = key.substr(key.find('.') + 1);
+        if (key.compare(0, strlen(NETWORK_NAME), NETWORK_NAME) == 0)
+            key = key.substr(strlen(NETWORK_NAME));
+        return key;
+    }
+
+    // expands "${renegingTime=1200, 1320}s" into "1200s" and "1320s"
+    std::vector<std::string> expandIteration(const std::string& value)
+    {
+        size_t begin = value.find("${");
+        if (begin == std::string::npos)
+            return std::vector<std::string>(1, value);
+        size_t end = value.find('}', begin);
+        if (end == std::string::npos)
+            throw std::runtime_error("unterminated iteration in '" + value + "'");
+
+        std::string body = value.substr(begin + 2, end - begin - 2);
+        size_t equals = body.find('=');
+        if (equals != std::string::npos)
+            body = body.substr(equals + 1);
+
+        std::vector<std::string> values;
+        std::stringstream items(body);
+        std::string item;
+        while (std::getline(items, item, ','))
+            values.push_back(value.substr(0, begin) + trim(item) + value.substr(end + 1));
+        return values;
+    }
+
+    bool assign(ModelParameters& parameters, const std::string& key, const std::vector<double>& means, bool exponential)
+    {
+        double *target = nullptr;
+        if (key == "source.interArrivalTime")
+            target = &parameters.interArrivalTime;
+        else if (key == "wifiQueue.serviceTime")
+            target = &parameters.wifiServiceTime;
+        else if (key == "cellularQueue.serviceTime")
+            target = &parameters.cellularServiceTime;
+        else if (key == "remoteQueue.serviceTime")
+            target = &parameters.remoteServiceTime;
+        else if (key == "wifiQueue.wifiStateDistribution")
+            target = &parameters.wifiStateTime;
+        else if (key == "wifiQueue.cellularStateDistribution")
+            target = &parameters.cellularStateTime;
+        else if (key == "wifiQueue.powerCoefficient")
+            target = &parameters.wifiPowerCoefficient;
+        else if (key == "cellularQueue.powerCoefficient")
+            target = &parameters.cellularPowerCoefficient;
+        else if (key == "wifiQueue.deadlineDistribution")
+            parameters.deadlines = means;
+        else
+            return false;
+
+        if (target) {
+            if (means.size() != 1)
+                throw std::runtime_error("iterations are only supported for the deadline, not for " + key);
+            *target = means[0];
+        }
+        if (!exponential && key.find("powerCoefficient") == std::string::npos)
+            parameters.approximated.push_back(key);
+        return true;
+    }
+}
+
+IniReader::IniReader(const std::string& path)
+{
+    std::ifstream input(path);
+    if (!input)
+        throw std::runtime_error("cannot open " + path);
+
+    std::string section = "General";
+    std::string line;
+    while (std::getline(input, line)) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line = line.substr(0, comment);
+        line = trim(line);
+        if (line.empty())
+            continue;
+
+        if (line[0] == '[') {
+            section = trim(line.substr(1, line.find(']') - 1));
+            if (section.compare(0, 7, "Config ") == 0)
+                section = trim(section.substr(7));
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos)
+            continue;
+        sections[section].push_back(std::make_pair(trim(line.substr(0, equals)), trim(line.substr(equals + 1))));
+    }
+}
+
+const std::string *IniReader::lookup(const std::string& config, const std::string& parameter) const
+{
+    // same precedence as OMNeT++: the configuration first, then the ones it extends, then General
+    std::string current = config;
+    while (!current.empty()) {
+        auto section = sections.find(current);
+        if (section == sections.end())
+            throw std::runtime_error("no configuration named " + current);
+
+        std::string parent = current == "General" ? "" : "General";
+        for (const auto& entry : section->second) {
+            if (entry.first == "extends")
+                parent = entry.second;
+            else if (normalizeKey(entry.first) == parameter)
+                return &entry.second;
+        }
+        current = parent;
+    }
+    return nullptr;
+}
+
+double IniReader::parseMean(const std::string& text, bool& exponential)
+{
+    std::string value = trim(text);
+    exponential = false;
+    if (value.compare(0, 12, "exponential(") == 0 && value.back() == ')') {
+        exponential = true;
+        value = trim(value.substr(12, value.size() - 13));
+    }
+
+    char *unit = nullptr;
+    double number = std::strtod(value.c_str(), &unit);
+    std::string suffix = trim(unit);
+    if (unit == value.c_str())
+        throw std::runtime_error("cannot parse the value '" + text + "'");
+    if (suffix.empty() || suffix == "s")
+        return number;
+    if (suffix == "ms")
+        return number / 1000.0;
+    if (suffix == "min")
+        return number * 60.0;
+    if (suffix == "h")
+        return number * 3600.0;
+    throw std::runtime_error("unknown unit in '" + text + "'");
+}
+
+ModelParameters IniReader::read(const std::string& config) const
+{
+    static const char *keys[] = {
+        "source.interArrivalTime", "wifiQueue.serviceTime", "cellularQueue.serviceTime", "remoteQueue.serviceTime",
+        "wifiQueue.wifiStateDistribution", "wifiQueue.cellularStateDistribution", "wifiQueue.deadlineDistribution",
+        "wifiQueue.powerCoefficient", "cellularQueue.powerCoefficient"
+    };
+
+    ModelParameters parameters;
+    for (const char *key : keys) {
+        const std::string *value = lookup(config, key);
+        if (!value)
+            continue;
+
+        bool exponential = true;
+        std::vector<double> means;
+        for (const std::string& item : expandIteration(*value)) {
+            bool itemExponential;
+            means.push_back(parseMean(item, itemExponential));
+            exponential = exponential && itemExponential;
+        }
+        assign(parameters, key, means, exponential);
+    }
+    return parameters;
+}
+
+void IniReader::applyOverride(ModelParameters& parameters, const std::string& assignment)
+{
+    size_t equals = assignment.find('=');
+    if (equals == std::string::npos)
+        throw std::runtime_error("override '" + assignment + "' is not key=value");
+
+    std::string key = normalizeKey(assignment.substr(0, equals));
+    std::vector<std::string> items;
+    std::stringstream values(assignment.substr(equals + 1));
+    std::string item;
+    while (std::getline(values, item, ','))
+        items.push_back(item);
+
+    bool exponential = true;
+    std::vector<double> means;
+    for (const std::string& value : items) {
+        bool itemExponential;
+        means.push_back(parseMean(value, itemExponential));
+        exponential = exponential && itemExponential;
+    }
+
+    // an override replaces the earlier note about the same parameter
+    parameters.approximated.erase(std::remove(parameters.approximated.begin(), parameters.approximated.end(), key), parameters.approximated.end());
+    if (!assign(parameters, key, means, exponential))
+        throw std::runtime_error("unknown parameter " + key);
+}
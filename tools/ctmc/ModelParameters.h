@@ -0,0 +1,58 @@
+/*
+ * ModelParameters.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef MODELPARAMETERS_H_
+#define MODELPARAMETERS_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Means (in seconds) of the distributions of the Full Offloading model and
+ * the power coefficients of the queues, as configured in omnetpp.ini.
+ */
+struct ModelParameters
+{
+    double interArrivalTime = 120.0;
+    double wifiServiceTime = 40.0;
+    double cellularServiceTime = 400.0;
+    double remoteServiceTime = 1.0;
+    double wifiStateTime = 3120.0;
+    double cellularStateTime = 1524.0;
+    double wifiPowerCoefficient = 0.7;
+    double cellularPowerCoefficient = 2.5;
+    std::vector<double> deadlines;
+
+    // parameters whose distribution is not exponential in the ini file
+    std::vector<std::string> approximated;
+};
+
+/**
+ * Minimal omnetpp.ini reader: the [General] section plus the requested
+ * configuration and the ones it extends. Only the parameters of the
+ * FullOffloadingNetwork listed in ModelParameters are looked up.
+ */
+class IniReader
+{
+    private:
+        // section name -> (key -> value), in file order
+        std::map<std::string, std::vector<std::pair<std::string, std::string>>> sections;
+
+        const std::string *lookup(const std::string& config, const std::string& parameter) const;
+        static double parseMean(const std::string& value, bool& exponential);
+
+    public:
+        explicit IniReader(const std::string& path);
+
+        ModelParameters read(const std::string& config) const;
+
+        // key=value overrides given on the command line, e.g. wifiQueue.serviceTime=exponential(30s)
+        static void applyOverride(ModelParameters& parameters, const std::string& assignment);
+};
+
+#endif /* MODELPARAMETERS_H_ */
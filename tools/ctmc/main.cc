@@ -0,0 +1,188 @@
+/*
+ * main.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ *
+ * Solves the CTMC of the Full Offloading model for every deadline of an
+ * omnetpp.ini configuration and prints MRT, MEC and ERWP with the same units
+ * as the simulation (see OffloadingMetrics.h).
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FullOffloadingChain.h"
+#include "ModelParameters.h"
+#include "OffloadingMetrics.h"
+
+namespace
+{
+    void usage(const char *program)
+    {
+        std::cerr << "Usage: " << program << " [options]\n"
+                  << "  -f FILE            ini file (default: omnetpp.ini)\n"
+                  << "  -c CONFIG          configuration (default: General)\n"
+                  << "  -s KEY=VALUE       override a parameter, e.g. -s 'wifiQueue.serviceTime=exponential(30s)'\n"
+                  << "                     or -s wifiQueue.deadlineDistribution=600s,1200s\n"
+                  << "  -w W1,W2,...       ERWP exponents (default: 0.1,0.5,0.9)\n"
+                  << "  -n N               max waiting jobs of each kind in the WiFi queue (default: 64)\n"
+                  << "  -m N               max jobs in the cellular queue (default: 160)\n"
+                  << "  -b MASS            warn when the truncation boundary has more probability (default: 1e-4)\n"
+                  << "  -t TOLERANCE       Gauss-Seidel stopping tolerance (default: 1e-9)\n"
+                  << "  -i ITERATIONS      Gauss-Seidel max iterations (default: 200000)\n"
+                  << "  -j N               deadlines solved in parallel, each with its own copy of the chain (default: 1)\n"
+                  << "  -o FILE            also write the results as CSV\n";
+    }
+
+    std::vector<double> parseList(const char *text)
+    {
+        std::vector<double> values;
+        std::string list(text);
+        size_t start = 0;
+        while (start <= list.size()) {
+            size_t comma = list.find(',', start);
+            if (comma == std::string::npos)
+                comma = list.size();
+            values.push_back(std::atof(list.substr(start, comma - start).c_str()));
+            start = comma + 1;
+        }
+        return values;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string iniFile = "omnetpp.ini";
+    std::string config = "General";
+    std::vector<std::string> overrides;
+    std::vector<double> exponents = { 0.1, 0.5, 0.9 };
+    int maxWaiting = 64;
+    int maxCellular = 160;
+    double maxBoundaryMass = 1e-4;
+    double tolerance = 1e-9;
+    int maxIterations = 200000;
+    int threads = 1;
+    std::string csvFile;
+
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "-h" || option == "--help") {
+            usage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc || option.size() != 2 || option[0] != '-') {
+            usage(argv[0]);
+            return 1;
+        }
+        const char *value = argv[++i];
+        switch (option[1]) {
+            case 'f': iniFile = value; break;
+            case 'c': config = value; break;
+            case 's': overrides.push_back(value); break;
+            case 'w': exponents = parseList(value); break;
+            case 'n': maxWaiting = std::atoi(value); break;
+            case 'm': maxCellular = std::atoi(value); break;
+            case 'b': maxBoundaryMass = std::atof(value); break;
+            case 't': tolerance = std::atof(value); break;
+            case 'i': maxIterations = std::atoi(value); break;
+            case 'j': threads = std::atoi(value); break;
+            case 'o': csvFile = value; break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    try {
+        ModelParameters parameters = IniReader(iniFile).read(config);
+        for (const std::string& assignment : overrides)
+            IniReader::applyOverride(parameters, assignment);
+        if (parameters.deadlines.empty())
+            throw std::runtime_error("no wifiQueue.deadlineDistribution in " + config);
+        for (const std::string& key : parameters.approximated)
+            std::cerr << "Note: " << key << " is not exponential, using an exponential distribution with the same mean\n";
+
+        std::cerr << FullOffloadingChain(parameters, maxWaiting, maxCellular).getStateCount() << " states, " << parameters.deadlines.size() << " deadlines\n";
+
+        // workers take the deadlines in order; within a worker each solution
+        // is the initial guess of its next deadline
+        const int count = parameters.deadlines.size();
+        std::vector<FullOffloadingChain::Solution> solutions(count);
+        std::vector<double> elapsed(count);
+        std::atomic<int> nextDeadline(0);
+        auto worker = [&]() {
+            FullOffloadingChain chain(parameters, maxWaiting, maxCellular);
+            std::vector<double> probabilities;
+            for (int i = nextDeadline++; i < count; i = nextDeadline++) {
+                auto start = std::chrono::steady_clock::now();
+                solutions[i] = chain.solve(parameters.deadlines[i], probabilities, tolerance, maxIterations);
+                elapsed[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+        };
+        std::vector<std::thread> pool;
+        for (int t = 1; t < std::max(1, std::min(threads, count)); t++)
+            pool.emplace_back(worker);
+        worker();
+        for (std::thread& thread : pool)
+            thread.join();
+
+        FILE *csv = nullptr;
+        if (!csvFile.empty()) {
+            csv = std::fopen(csvFile.c_str(), "w");
+            if (!csv)
+                throw std::runtime_error("cannot write " + csvFile);
+            std::fprintf(csv, "Deadline [s], Deadline [min], Reneging Rate r, MRT, MEC");
+            for (double w : exponents)
+                std::fprintf(csv, ", %s", OffloadingMetrics::erwpName(w).c_str());
+            std::fprintf(csv, ", Offloaded Ratio, Truncation Mass, Iterations\n");
+        }
+
+        std::printf("%10s %8s %8s", "Deadline", "MRT", "MEC");
+        for (double w : exponents)
+            std::printf(" %12s", OffloadingMetrics::erwpName(w).c_str());
+        std::printf(" %10s %10s %6s %8s\n", "offloaded", "boundary", "iters", "time");
+
+        for (int i = 0; i < count; i++) {
+            double deadline = parameters.deadlines[i];
+            const FullOffloadingChain::Solution& solution = solutions[i];
+            const FullOffloadingChain::Metrics& metrics = solution.metrics;
+            double mrt = OffloadingMetrics::meanResponseTime(metrics.responseTime, 1);
+            double mec = OffloadingMetrics::meanEnergyConsumption(metrics.energy, 1);
+
+            std::printf("%9.0fs %8.4f %8.4f", deadline, mrt, mec);
+            for (double w : exponents)
+                std::printf(" %12.4f", OffloadingMetrics::erwp(mec, mrt, w));
+            std::printf(" %10.4f %10.2e %6d %7.2fs\n", metrics.offloadedRatio, metrics.truncationMass, solution.iterations, elapsed[i]);
+
+            if (csv) {
+                std::fprintf(csv, "%.0f, %.0f, %.4f, %.4f, %.4f", deadline, deadline / 60.0, 60.0 / deadline, mrt, mec);
+                for (double w : exponents)
+                    std::fprintf(csv, ", %.4f", OffloadingMetrics::erwp(mec, mrt, w));
+                std::fprintf(csv, ", %.4f, %.2e, %d\n", metrics.offloadedRatio, metrics.truncationMass, solution.iterations);
+            }
+
+            if (solution.iterations >= maxIterations)
+                std::cerr << "Warning: no convergence for deadline " << deadline << "s (change above " << tolerance << ")\n";
+            if (metrics.truncationMass > maxBoundaryMass)
+                std::cerr << "Warning: probability " << metrics.truncationMass << " on the truncation boundary for deadline " << deadline << "s, increase -n/-m\n";
+        }
+
+        if (csv)
+            std::fclose(csv);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
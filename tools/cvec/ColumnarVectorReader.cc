@@ -0,0 +1,129 @@
+/*
+ * ColumnarVectorReader.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "ColumnarVectorReader.h"
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace ColumnarVectorFormat;
+
+ColumnarVectorReader::ColumnarVectorReader(const std::string& fileName) : fileName(fileName)
+{
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("cannot open " + fileName);
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("cannot read " + fileName);
+    }
+    size = info.st_size;
+
+    const size_t headerSize = sizeof(FILE_MAGIC) + 4;
+    const size_t trailerSize = 8 + sizeof(INDEX_MAGIC);
+    if (size < headerSize + trailerSize) {
+        close(fd);
+        throw std::runtime_error(fileName + " is not a complete .cvec file");
+    }
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        throw std::runtime_error("cannot map " + fileName);
+    data = (const unsigned char *)mapping;
+
+    try {
+        Cursor header(data, headerSize);
+        if (std::memcmp(header.take(sizeof(FILE_MAGIC)), FILE_MAGIC, sizeof(FILE_MAGIC)) != 0)
+            throw std::runtime_error(fileName + " is not a .cvec file");
+        if (header.getFixed(4) != VERSION)
+            throw std::runtime_error(fileName + " has an unsupported version");
+
+        // a run that did not finish has no index
+        Cursor trailer(data + size - trailerSize, trailerSize);
+        uint64_t indexOffset = trailer.getFixed(8);
+        if (std::memcmp(trailer.take(sizeof(INDEX_MAGIC)), INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 || indexOffset < headerSize || indexOffset > size - trailerSize)
+            throw std::runtime_error(fileName + " has no index, the run did not finish");
+        index = decodeIndex(data + indexOffset, size - trailerSize - indexOffset);
+    }
+    catch (...) {
+        munmap((void *)data, size);
+        throw;
+    }
+    timeScale = std::pow(10.0, index.scaleExp);
+}
+
+ColumnarVectorReader::~ColumnarVectorReader()
+{
+    munmap((void *)data, size);
+}
+
+std::vector<const VectorInfo *> ColumnarVectorReader::findVectors(const std::string& modulePattern, const std::string& namePattern) const
+{
+    std::vector<const VectorInfo *> found;
+    for (const VectorInfo& vector : index.vectors) {
+        if (!modulePattern.empty() && fnmatch(modulePattern.c_str(), vector.module.c_str(), 0) != 0)
+            continue;
+        if (!namePattern.empty() && fnmatch(namePattern.c_str(), vector.name.c_str(), 0) != 0)
+            continue;
+        found.push_back(&vector);
+    }
+    return found;
+}
+
+void ColumnarVectorReader::readVector(const VectorInfo& vector, const BlockCallback& callback, double from, double to) const
+{
+    std::vector<int64_t> rawTimes;
+    std::vector<double> values;
+    std::vector<double> times;
+    for (const BlockInfo& block : vector.blocks) {
+        if (block.lastTime * timeScale < from || block.firstTime * timeScale > to)
+            continue;
+        if (block.offset >= size)
+            throw std::runtime_error(fileName + " has a block outside the file");
+
+        rawTimes.clear();
+        values.clear();
+        decodeBlock(data + block.offset, size - block.offset, rawTimes, values);
+
+        times.clear();
+        size_t kept = 0;
+        for (size_t i = 0; i < rawTimes.size(); i++) {
+            double time = rawTimes[i] * timeScale;
+            if (time < from || time > to)
+                continue;
+            times.push_back(time);
+            values[kept++] = values[i];
+        }
+        values.resize(kept);
+        if (!times.empty())
+            callback(times, values);
+    }
+}
+
+uint64_t ColumnarVectorReader::getStoredBytes(const VectorInfo& vector) const
+{
+    uint64_t bytes = 0;
+    for (const BlockInfo& block : vector.blocks) {
+        Cursor header(data + block.offset, size - block.offset);
+        header.getFixed(8);
+        uint8_t flags = header.getFixed(1);
+        uint64_t timeBytes = header.getFixed(4);
+        uint64_t valueBytes = header.getFixed(4);
+        if (flags & DEFLATE)
+            header.getFixed(8);
+        bytes += (size - block.offset - header.remaining()) + timeBytes + valueBytes;
+    }
+    return bytes;
+}
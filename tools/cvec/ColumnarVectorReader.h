@@ -0,0 +1,52 @@
+/*
+ * ColumnarVectorReader.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef COLUMNARVECTORREADER_H_
+#define COLUMNARVECTORREADER_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ColumnarVectorFormat.h"
+
+/**
+ * Memory-mapped .cvec file. Only the index is decoded when the file is
+ * opened; the blocks of a vector are decoded one at a time when it is read,
+ * so memory does not grow with the file.
+ */
+class ColumnarVectorReader
+{
+    public:
+        // samples of one block, times in seconds
+        typedef std::function<void(const std::vector<double>& times, const std::vector<double>& values)> BlockCallback;
+
+    private:
+        std::string fileName;
+        const unsigned char *data;
+        size_t size;
+        ColumnarVectorFormat::Index index;
+        double timeScale;
+
+    public:
+        explicit ColumnarVectorReader(const std::string& fileName);
+        ~ColumnarVectorReader();
+
+        const ColumnarVectorFormat::Index& getIndex() const { return index; }
+        size_t getFileSize() const { return size; }
+
+        // vectors whose module and name match the glob patterns (empty matches all)
+        std::vector<const ColumnarVectorFormat::VectorInfo *> findVectors(const std::string& modulePattern, const std::string& namePattern) const;
+
+        // calls back with every block overlapping [from, to]; samples outside are dropped
+        void readVector(const ColumnarVectorFormat::VectorInfo& vector, const BlockCallback& callback, double from = -1e300, double to = 1e300) const;
+        // bytes of the blocks of the vector, as stored
+        uint64_t getStoredBytes(const ColumnarVectorFormat::VectorInfo& vector) const;
+};
+
+#endif /* COLUMNARVECTORREADER_H_ */
@@ -0,0 +1,150 @@
+/*
+ * main.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ *
+ * Lists and exports the vectors of .cvec files written by
+ * ColumnarOutputVectorManager, reading only the blocks it needs.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ColumnarVectorReader.h"
+
+using namespace ColumnarVectorFormat;
+
+namespace
+{
+    void usage(const char *program)
+    {
+        std::cerr << "Usage: " << program << " COMMAND [options] FILE...\n"
+                  << "Commands:\n"
+                  << "  info               run attributes, vectors and sizes\n"
+                  << "  list               one line per vector: module, name, samples, min, max, mean\n"
+                  << "  export             samples as CSV (file, module, name, time, value)\n"
+                  << "Options:\n"
+                  << "  -m PATTERN         module glob, e.g. '*.wifiQueue'\n"
+                  << "  -n PATTERN         vector name glob, e.g. 'totalResponseTime:*'\n"
+                  << "  -f TIME            export samples from this time [s]\n"
+                  << "  -t TIME            export samples up to this time [s]\n"
+                  << "  -o FILE            write to FILE instead of the standard output\n";
+    }
+
+    std::string csvField(const std::string& text)
+    {
+        if (text.find_first_of(",\"\n") == std::string::npos)
+            return text;
+        std::string quoted = "\"";
+        for (char c : text) {
+            if (c == '"')
+                quoted += '"';
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+
+    void info(const std::string& fileName, const ColumnarVectorReader& reader, FILE *out)
+    {
+        const Index& index = reader.getIndex();
+        std::fprintf(out, "%s: %zu bytes, %zu vectors, simtime scale 1e%d\n", fileName.c_str(), reader.getFileSize(), index.vectors.size(), index.scaleExp);
+        for (const auto& attribute : index.runAttributes)
+            std::fprintf(out, "  %s = %s\n", attribute.first.c_str(), attribute.second.c_str());
+        for (const VectorInfo& vector : index.vectors) {
+            uint64_t stored = reader.getStoredBytes(vector);
+            std::fprintf(out, "  %s %s: %llu samples in %zu blocks, %llu bytes (%.2f bytes/sample)%s%s\n", vector.module.c_str(), vector.name.c_str(),
+                    (unsigned long long)vector.samples, vector.blocks.size(), (unsigned long long)stored, vector.samples ? (double)stored / vector.samples : 0.0,
+                    (vector.flags & FLOAT32) ? ", float32" : "", (vector.flags & DEFLATE) ? ", deflate" : "");
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help") {
+        usage(argv[0]);
+        return argc < 2 ? 1 : 0;
+    }
+    std::string command = argv[1];
+    if (command != "info" && command != "list" && command != "export") {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::string modulePattern, namePattern, outFile;
+    double from = -1e300, to = 1e300;
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; i++) {
+        std::string option = argv[i];
+        if (option.size() == 2 && option[0] == '-') {
+            if (i + 1 >= argc) {
+                usage(argv[0]);
+                return 1;
+            }
+            const char *value = argv[++i];
+            switch (option[1]) {
+                case 'm': modulePattern = value; break;
+                case 'n': namePattern = value; break;
+                case 'f': from = std::atof(value); break;
+                case 't': to = std::atof(value); break;
+                case 'o': outFile = value; break;
+                default:
+                    usage(argv[0]);
+                    return 1;
+            }
+        }
+        else
+            files.push_back(option);
+    }
+    if (files.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FILE *out = stdout;
+    if (!outFile.empty() && !(out = std::fopen(outFile.c_str(), "w"))) {
+        std::cerr << "Error: cannot write " << outFile << "\n";
+        return 1;
+    }
+
+    try {
+        if (command == "export")
+            std::fprintf(out, "file,module,name,time,value\n");
+        for (const std::string& fileName : files) {
+            ColumnarVectorReader reader(fileName);
+            if (command == "info") {
+                info(fileName, reader, out);
+                continue;
+            }
+
+            for (const VectorInfo *vector : reader.findVectors(modulePattern, namePattern)) {
+                if (command == "list") {
+                    std::fprintf(out, "%s %s %s %llu %.17g %.17g %.17g\n", fileName.c_str(), vector->module.c_str(), vector->name.c_str(), (unsigned long long)vector->samples,
+                            vector->min, vector->max, vector->samples ? vector->sum / vector->samples : 0.0);
+                    continue;
+                }
+
+                std::string prefix = csvField(fileName) + "," + csvField(vector->module) + "," + csvField(vector->name) + ",";
+                reader.readVector(*vector, [&](const std::vector<double>& times, const std::vector<double>& values) {
+                    for (size_t i = 0; i < times.size(); i++)
+                        std::fprintf(out, "%s%.17g,%.17g\n", prefix.c_str(), times[i], values[i]);
+                }, from, to);
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    if (out != stdout && std::fclose(out) != 0) {
+        std::cerr << "Error: cannot write " << outFile << "\n";
+        return 1;
+    }
+    return 0;
+}
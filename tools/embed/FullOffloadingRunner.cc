@@ -0,0 +1,346 @@
+/*
+ * FullOffloadingRunner.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#include "FullOffloadingRunner.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <omnetpp/cnullenvir.h>
+
+#include "OffloadingMetrics.h"
+
+using namespace omnetpp;
+
+namespace
+{
+    // no configuration: every option (profile-events, variate-block-size...) takes its default
+    class EmptyConfig : public cConfiguration
+    {
+        private:
+            class NullKeyValue : public KeyValue
+            {
+                public:
+                    virtual const char *getKey() const override { return nullptr; }
+                    virtual const char *getValue() const override { return nullptr; }
+                    virtual const char *getBaseDirectory() const override { return nullptr; }
+            };
+            NullKeyValue nullKeyValue;
+
+        protected:
+            virtual const char *substituteVariables(const char *value) const override { return value; }
+
+        public:
+            virtual const char *getConfigValue(const char *key) const override { return nullptr; }
+            virtual const KeyValue& getConfigEntry(const char *key) const override { return nullKeyValue; }
+            virtual const char *getPerObjectConfigValue(const char *objectFullPath, const char *keySuffix) const override { return nullptr; }
+            virtual const KeyValue& getPerObjectConfigEntry(const char *objectFullPath, const char *keySuffix) const override { return nullKeyValue; }
+    };
+
+    // assigns the parameters from a map and keeps the scalars of the sink
+    class RunnerEnvir : public cNullEnvir
+    {
+        private:
+            const std::map<std::string, std::string>& values;
+            std::map<std::string, double>& sinkScalars;
+
+        public:
+            RunnerEnvir(int seed, const std::map<std::string, std::string>& values, std::map<std::string, double>& sinkScalars)
+                : cNullEnvir(0, nullptr, new EmptyConfig()), values(values), sinkScalars(sinkScalars) {
+                rng->initialize(seed, 0, 1, 0, 1, cfg);
+            }
+
+            virtual void readParameter(cPar *par) override {
+                // the path below the network, e.g. wifiQueue.serviceTime
+                std::string path = par->getFullPath();
+                path = path.substr(path.find('.') + 1);
+                auto it = values.find(path);
+                if (it != values.end())
+                    par->parse(it->second.c_str());
+                else if (par->containsValue())
+                    par->acceptDefault();
+                else
+                    throw cRuntimeError("No value for parameter %s", path.c_str());
+            }
+
+            virtual void recordScalar(cComponent *component, const char *name, double value, opp_string_map *attributes = nullptr) override {
+                if (strcmp(component->getName(), "sink") == 0)
+                    sinkScalars[name] = value;
+            }
+    };
+
+    std::string seconds(double value)
+    {
+        std::ostringstream text;
+        text.precision(17);
+        text << value << "s";
+        return text.str();
+    }
+
+    std::string exponential(double mean)
+    {
+        return "exponential(" + seconds(mean) + ")";
+    }
+
+    std::string number(double value)
+    {
+        std::ostringstream text;
+        text.precision(17);
+        text << value;
+        return text.str();
+    }
+
+    // same parameters as the StreamingExecution configuration of omnetpp.ini
+    std::map<std::string, std::string> parameterValues(const FullOffloadingParams& params)
+    {
+        std::string exponents;
+        for (double w : params.erwpExponents)
+            exponents += (exponents.empty() ? "" : " ") + number(w);
+
+        std::map<std::string, std::string> values = {
+            { "source.interArrivalTime", exponential(params.interArrivalTime) },
+            { "source.recycleJobs", "true" },
+            { "wifiQueue.serviceTime", exponential(params.wifiServiceTime) },
+            { "wifiQueue.wifiStateDistribution", exponential(params.wifiStateDuration) },
+            { "wifiQueue.cellularStateDistribution", exponential(params.cellularStateDuration) },
+            { "wifiQueue.deadlineDistribution", seconds(params.deadline) },
+            { "wifiQueue.powerCoefficient", number(params.wifiPowerCoefficient) },
+            { "cellularQueue.serviceTime", exponential(params.cellularServiceTime) },
+            { "cellularQueue.powerCoefficient", number(params.cellularPowerCoefficient) },
+            { "remoteQueue.serviceTime", exponential(params.remoteServiceTime) },
+            { "sink.numJobs", number(params.numJobs) },
+            { "sink.streamingStatistics", "true" },
+            { "sink.erwpExponents", "\"" + exponents + "\"" },
+            { "sink.recycleJobs", "true" },
+        };
+        for (const auto& entry : params.overrides)
+            values[entry.first] = entry.second;
+        return values;
+    }
+
+    // NaN if the sink did not record it, and the first missing name goes in error
+    double scalar(FullOffloadingMetrics& metrics, const std::string& name)
+    {
+        auto it = metrics.scalars.find(name);
+        if (it != metrics.scalars.end())
+            return it->second;
+        if (metrics.error.empty())
+            metrics.error = "the sink recorded no " + name + " scalar";
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+FullOffloadingRunner::FullOffloadingRunner(const std::string& nedPath)
+{
+    CodeFragments::executeAll(CodeFragments::STARTUP);
+    SimTime::setScaleExp(-12);
+
+    size_t start = 0;
+    while (start <= nedPath.size()) {
+        size_t colon = nedPath.find(':', start);
+        if (colon == std::string::npos)
+            colon = nedPath.size();
+        if (colon > start)
+            cSimulation::loadNedSourceFolder(nedPath.substr(start, colon - start).c_str());
+        start = colon + 1;
+    }
+    cSimulation::doneLoadingNedFiles();
+
+    if (!cModuleType::find("FullOffloadingNetwork"))
+        throw std::runtime_error("FullOffloadingNetwork not found in " + nedPath);
+}
+
+FullOffloadingRunner::~FullOffloadingRunner()
+{
+    CodeFragments::executeAll(CodeFragments::SHUTDOWN);
+}
+
+FullOffloadingMetrics FullOffloadingRunner::run(const FullOffloadingParams& params, int seed)
+{
+    FullOffloadingMetrics metrics;
+    metrics.seed = seed;
+    auto start = std::chrono::steady_clock::now();
+
+    std::map<std::string, std::string> values = parameterValues(params);
+    cSimulation *simulation = new cSimulation("simulation", new RunnerEnvir(seed, values, metrics.scalars));
+    cSimulation::setActiveSimulation(simulation);
+
+    try {
+        simulation->setupNetwork(cModuleType::find("FullOffloadingNetwork"));
+        simulation->setWarmupPeriod(params.warmupPeriod);
+        if (params.simTimeLimit > 0)
+            simulation->setSimulationTimeLimit(params.simTimeLimit);
+        simulation->callInitialize();
+
+        try {
+            while (cEvent *event = simulation->takeNextEvent())
+                simulation->executeEvent(event);
+        }
+        catch (cTerminationException& e) {
+            // endSimulation() of the sink, as opposed to the time limit or an empty event set
+            metrics.completed = e.getErrorCode() == E_ENDSIM;
+        }
+        metrics.simTime = simulation->getSimTime().dbl();
+        metrics.events = simulation->getEventNumber();
+        simulation->callFinish();
+    }
+    catch (std::exception& e) {
+        metrics.error = e.what();
+    }
+
+    simulation->deleteNetwork();
+    cSimulation::setActiveSimulation(nullptr);
+    delete simulation;  // and the environment
+
+    double jobs = scalar(metrics, "jobs");
+    metrics.jobs = std::isnan(jobs) ? 0 : (long)jobs;
+    metrics.mrt = scalar(metrics, "MRT");
+    metrics.mec = scalar(metrics, "MEC");
+    for (double w : params.erwpExponents)
+        metrics.erwp.push_back(scalar(metrics, OffloadingMetrics::erwpName(w)));
+    metrics.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return metrics;
+}
+
+std::vector<FullOffloadingMetrics> FullOffloadingRunner::runReplications(const FullOffloadingParams& params, const std::vector<int>& seeds, int workers)
+{
+    std::vector<FullOffloadingMetrics> results(seeds.size());
+    if (workers <= 1) {
+        for (size_t i = 0; i < seeds.size(); i++)
+            results[i] = run(params, seeds[i]);
+        return results;
+    }
+
+    struct Worker {
+        pid_t pid;
+        size_t index;
+        int fd;
+        std::string data;
+    };
+    std::vector<Worker> running;
+    size_t next = 0;
+
+    while (next < seeds.size() || !running.empty()) {
+        while (next < seeds.size() && (int)running.size() < workers) {
+            int fds[2];
+            if (pipe(fds) != 0)
+                throw std::runtime_error(std::string("pipe: ") + strerror(errno));
+            std::fflush(nullptr);
+            pid_t pid = fork();
+            if (pid < 0)
+                throw std::runtime_error(std::string("fork: ") + strerror(errno));
+            if (pid == 0) {
+                close(fds[0]);
+                std::string data = serialize(run(params, seeds[next]));
+                for (size_t written = 0; written < data.size(); ) {
+                    ssize_t n = write(fds[1], data.data() + written, data.size() - written);
+                    if (n <= 0)
+                        _exit(1);
+                    written += n;
+                }
+                _exit(0);
+            }
+            close(fds[1]);
+            running.push_back(Worker{pid, next++, fds[0], std::string()});
+        }
+
+        // read the results as they come, a worker is done at end of file
+        std::vector<pollfd> fds;
+        for (const Worker& worker : running)
+            fds.push_back(pollfd{worker.fd, POLLIN, 0});
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error(std::string("poll: ") + strerror(errno));
+        }
+
+        for (size_t i = fds.size(); i-- > 0; ) {
+            if (!fds[i].revents)
+                continue;
+            Worker& worker = running[i];
+            char buffer[4096];
+            ssize_t n = read(worker.fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                worker.data.append(buffer, n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR)
+                continue;
+
+            close(worker.fd);
+            int status = 0;
+            waitpid(worker.pid, &status, 0);
+            if (WIFEXITED(status) && WEXITSTATUS(status) == 0 && !worker.data.empty())
+                results[worker.index] = deserialize(worker.data);
+            else {
+                results[worker.index].seed = seeds[worker.index];
+                results[worker.index].error = "worker process failed";
+            }
+            running.erase(running.begin() + i);
+        }
+    }
+    return results;
+}
+
+std::string FullOffloadingRunner::serialize(const FullOffloadingMetrics& metrics)
+{
+    // one value per line, as the scalar names have no newlines
+    std::ostringstream out;
+    out.precision(17);
+    out << metrics.seed << '\n' << metrics.completed << '\n' << metrics.jobs << '\n' << metrics.mrt << '\n' << metrics.mec << '\n'
+        << metrics.simTime << '\n' << metrics.events << '\n' << metrics.elapsed << '\n';
+    out << metrics.erwp.size() << '\n';
+    for (double value : metrics.erwp)
+        out << value << '\n';
+    out << metrics.scalars.size() << '\n';
+    for (const auto& entry : metrics.scalars)
+        out << entry.first << '\n' << entry.second << '\n';
+    out << metrics.error;
+    return out.str();
+}
+
+FullOffloadingMetrics FullOffloadingRunner::deserialize(const std::string& data)
+{
+    std::istringstream in(data);
+    auto line = [&in]() {
+        std::string text;
+        if (!std::getline(in, text))
+            throw std::runtime_error("truncated worker result");
+        return text;
+    };
+
+    // stod, unlike operator>>, reads the nan of a run without jobs
+    FullOffloadingMetrics metrics;
+    metrics.seed = std::stoi(line());
+    metrics.completed = std::stoi(line()) != 0;
+    metrics.jobs = std::stol(line());
+    metrics.mrt = std::stod(line());
+    metrics.mec = std::stod(line());
+    metrics.simTime = std::stod(line());
+    metrics.events = std::stol(line());
+    metrics.elapsed = std::stod(line());
+    metrics.erwp.resize(std::stoul(line()));
+    for (double& value : metrics.erwp)
+        value = std::stod(line());
+    size_t count = std::stoul(line());
+    for (size_t i = 0; i < count; i++) {
+        std::string name = line();
+        metrics.scalars[name] = std::stod(line());
+    }
+    std::getline(in, metrics.error, '\0');
+    return metrics;
+}
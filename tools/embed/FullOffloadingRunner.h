@@ -0,0 +1,97 @@
+/*
+ * FullOffloadingRunner.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ */
+
+#ifndef FULLOFFLOADINGRUNNER_H_
+#define FULLOFFLOADINGRUNNER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <omnetpp.h>
+
+/**
+ * Parameters of a FullOffloadingNetwork run, with the values of the
+ * StreamingExecution configuration of omnetpp.ini. Times are in seconds;
+ * the distributions are exponential with the given mean, the deadline is
+ * constant.
+ */
+struct FullOffloadingParams
+{
+    double interArrivalTime = 120;
+    double wifiServiceTime = 40;
+    double wifiStateDuration = 3120;
+    double cellularStateDuration = 1524;
+    double deadline = 3600;
+    double cellularServiceTime = 400;
+    double remoteServiceTime = 1;
+    double wifiPowerCoefficient = 0.7;
+    double cellularPowerCoefficient = 2.5;
+
+    double warmupPeriod = 1000000;
+    long numJobs = 30000;            // measured jobs at the sink
+    double simTimeLimit = 0;         // 0: until the sink has numJobs jobs
+    std::vector<double> erwpExponents = { 0.1, 0.5, 0.9 };
+
+    // NED expressions by parameter path below the network, applied last,
+    // e.g. "wifiQueue.fifo" -> "false" or "wifiQueue.deadlineDistribution" -> "exponential(3600s)"
+    std::map<std::string, std::string> overrides;
+};
+
+/**
+ * Results of one run: the streaming metrics of the sink (minutes, as in
+ * OffloadingMetrics.h) and all the scalars it recorded. A metric the sink
+ * did not record is NaN, and error says which one.
+ */
+struct FullOffloadingMetrics
+{
+    int seed = 0;
+    bool completed = false;          // the sink ended the run
+    std::string error;               // empty unless the run failed
+    long jobs = 0;
+    double mrt = 0;
+    double mec = 0;
+    std::vector<double> erwp;        // one per exponent of the parameters
+    double simTime = 0;              // s
+    long events = 0;
+    double elapsed = 0;              // wall-clock s
+    std::map<std::string, double> scalars;
+};
+
+/**
+ * Runs FullOffloadingNetwork inside the calling process, without Cmdenv or
+ * ini files: the NED files are loaded once by the constructor and every run
+ * only sets up the network, with the parameters assigned directly.
+ *
+ * The simulation kernel keeps its state in globals (active simulation,
+ * environment, registration lists), so a single run at a time can be active
+ * in a process. runReplications() runs the replications concurrently in
+ * forked worker processes, which share the loaded NED types with the
+ * caller and send back their metrics through a pipe.
+ *
+ * Only one runner may exist, and it should be created at the top of main().
+ */
+class FullOffloadingRunner
+{
+    private:
+        omnetpp::cStaticFlag staticFlag;
+
+        static std::string serialize(const FullOffloadingMetrics& metrics);
+        static FullOffloadingMetrics deserialize(const std::string& data);
+
+    public:
+        // nedPath: folders separated by ':', e.g. ".:$QUEUEINGLIB"
+        explicit FullOffloadingRunner(const std::string& nedPath);
+        ~FullOffloadingRunner();
+
+        FullOffloadingMetrics run(const FullOffloadingParams& params, int seed);
+
+        // results in the order of the seeds; workers <= 1 runs them in this process
+        std::vector<FullOffloadingMetrics> runReplications(const FullOffloadingParams& params, const std::vector<int>& seeds, int workers);
+};
+
+#endif /* FULLOFFLOADINGRUNNER_H_ */
@@ -0,0 +1,130 @@
+/*
+ * main.cc
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: matteo
+ *
+ * Runs replications of the Full Offloading model in process (see
+ * FullOffloadingRunner.h) and prints MRT, MEC and ERWP of every replication
+ * with their mean and confidence interval.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "FullOffloadingRunner.h"
+#include "OffloadingMetrics.h"
+
+namespace
+{
+    void usage(const char *program)
+    {
+        std::cerr << "Usage: " << program << " [options]\n"
+                  << "  -n PATH            NED folders separated by ':' (default: .:$QUEUEINGLIB)\n"
+                  << "  -d DEADLINE        deadline in seconds (default: 3600)\n"
+                  << "  -r N               replications, with seeds 0..N-1 (default: 10)\n"
+                  << "  -j N               replications run concurrently, in worker processes (default: 1)\n"
+                  << "  -W WARMUP          warmup period in seconds (default: 1000000)\n"
+                  << "  -J JOBS            measured jobs per replication (default: 30000)\n"
+                  << "  -s KEY=VALUE       set a parameter with a NED expression, e.g. -s 'wifiQueue.serviceTime=exponential(30s)'\n"
+                  << "  -c CONFIDENCE      confidence level of the intervals (default: 0.9)\n";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *queueinglib = std::getenv("QUEUEINGLIB");
+    std::string nedPath = std::string(".") + (queueinglib ? std::string(":") + queueinglib : "");
+    FullOffloadingParams params;
+    int replications = 10;
+    int workers = 1;
+    double confidence = 0.9;
+
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "-h" || option == "--help") {
+            usage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc || option.size() != 2 || option[0] != '-') {
+            usage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+        switch (option[1]) {
+            case 'n': nedPath = value; break;
+            case 'd': params.deadline = std::atof(value.c_str()); break;
+            case 'r': replications = std::atoi(value.c_str()); break;
+            case 'j': workers = std::atoi(value.c_str()); break;
+            case 'W': params.warmupPeriod = std::atof(value.c_str()); break;
+            case 'J': params.numJobs = std::atol(value.c_str()); break;
+            case 'c': confidence = std::atof(value.c_str()); break;
+            case 's': {
+                size_t equals = value.find('=');
+                if (equals == std::string::npos) {
+                    usage(argv[0]);
+                    return 1;
+                }
+                params.overrides[value.substr(0, equals)] = value.substr(equals + 1);
+                break;
+            }
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    try {
+        FullOffloadingRunner runner(nedPath);
+        std::vector<int> seeds;
+        for (int seed = 0; seed < replications; seed++)
+            seeds.push_back(seed);
+        std::vector<FullOffloadingMetrics> results = runner.runReplications(params, seeds, workers);
+
+        std::printf("%6s %8s %8s", "Seed", "MRT", "MEC");
+        for (double w : params.erwpExponents)
+            std::printf(" %12s", OffloadingMetrics::erwpName(w).c_str());
+        std::printf(" %8s %12s %8s\n", "jobs", "events", "time");
+
+        RunningStatistic mrt, mec;
+        std::vector<RunningStatistic> erwp(params.erwpExponents.size());
+        int failed = 0;
+        for (const FullOffloadingMetrics& metrics : results) {
+            if (!metrics.error.empty() || !metrics.completed) {
+                std::cerr << "Seed " << metrics.seed << ": " << (metrics.error.empty() ? "the sink did not end the run" : metrics.error) << "\n";
+                failed++;
+                continue;
+            }
+            std::printf("%6d %8.4f %8.4f", metrics.seed, metrics.mrt, metrics.mec);
+            for (double value : metrics.erwp)
+                std::printf(" %12.4f", value);
+            std::printf(" %8ld %12ld %7.2fs\n", metrics.jobs, metrics.events, metrics.elapsed);
+
+            mrt.collect(metrics.mrt);
+            mec.collect(metrics.mec);
+            for (size_t i = 0; i < erwp.size(); i++)
+                erwp[i].collect(metrics.erwp[i]);
+        }
+
+        if (mrt.getCount() > 1) {
+            std::printf("%6s %8.4f %8.4f", "mean", mrt.getMean(), mec.getMean());
+            for (const RunningStatistic& values : erwp)
+                std::printf(" %12.4f", values.getMean());
+            std::printf("\n%6s %8.4f %8.4f", "+-", OffloadingMetrics::confidenceHalfWidth(mrt, confidence), OffloadingMetrics::confidenceHalfWidth(mec, confidence));
+            for (const RunningStatistic& values : erwp)
+                std::printf(" %12.4f", OffloadingMetrics::confidenceHalfWidth(values, confidence));
+            std::printf("\n");
+        }
+        if (failed > 0)
+            return 1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}